@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRunner.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+
+#include <cstdio>
+
+int main(int argc, char **argv) {
+    QCoreApplication application(argc, argv);
+
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Benchmarks the component loader and the object registry.");
+    parser.addHelpOption();
+
+    QCommandLineOption iterationsOption("iterations", "Number of iterations of each benchmark.", "count", "5");
+    QCommandLineOption componentsOption("components", "Folder containing the component topologies.", "folder",
+                                        NEDRYSOFT_BENCHMARK_COMPONENT_DIR);
+    QCommandLineOption registryOption("registry-sizes", "Comma separated registry sizes.", "sizes",
+                                      "10,100,1000,10000,100000");
+    QCommandLineOption lookupsOption("lookups", "Number of lookups averaged per registry sample.", "count", "10000");
+    QCommandLineOption parallelOption("parallel", "Load component libraries concurrently.");
+    QCommandLineOption outputOption("output", "File the JSON results are written to.", "filename",
+                                    "ComponentSystemBenchmark.json");
+
+    parser.addOptions({iterationsOption, componentsOption, registryOption, lookupsOption, parallelOption,
+                       outputOption});
+
+    parser.process(application);
+
+    BenchmarkRunner benchmarkRunner(parser.value(iterationsOption).toInt());
+
+    QDir componentsDir(parser.value(componentsOption));
+
+    for (const auto &topology : componentsDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        benchmarkRunner.benchmarkTopology(topology, componentsDir.absoluteFilePath(topology),
+                                          parser.isSet(parallelOption));
+    }
+
+    for (const auto &size : parser.value(registryOption).split(",")) {
+        if (size.toInt() > 0) {
+            benchmarkRunner.benchmarkRegistry(size.toInt(), qMax(1, parser.value(lookupsOption).toInt()));
+        }
+    }
+
+    QFile outputFile(parser.value(outputOption));
+
+    if (!outputFile.open(QFile::WriteOnly | QFile::Truncate)) {
+        fprintf(stderr, "unable to write results to %s\n", qPrintable(parser.value(outputOption)));
+
+        return 1;
+    }
+
+    outputFile.write(QJsonDocument(benchmarkRunner.results()).toJson());
+
+    return 0;
+}
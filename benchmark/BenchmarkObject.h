@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_COMPONENTSYSTEM_BENCHMARKOBJECT_H
+#define NEDRYSOFT_COMPONENTSYSTEM_BENCHMARKOBJECT_H
+
+#include <QObject>
+
+/**
+ * @brief       The interface that the registry benchmarks look up.
+ */
+class IBenchmarkInterface {
+    public:
+        /**
+         * @brief       Destroys the IBenchmarkInterface.
+         */
+        virtual ~IBenchmarkInterface() = default;
+
+        /**
+         * @brief       Returns the value of the object.
+         *
+         * @returns     the value.
+         */
+        virtual auto value() const -> int = 0;
+};
+
+Q_DECLARE_INTERFACE(IBenchmarkInterface, "com.nedrysoft.componentsystem.IBenchmarkInterface/1.0.0")
+
+/**
+ * @brief       The object that is stored in the registry by the registry benchmarks.
+ */
+class BenchmarkObject :
+        public QObject,
+        public IBenchmarkInterface {
+
+    private:
+        Q_OBJECT
+
+        Q_INTERFACES(IBenchmarkInterface)
+
+    public:
+        /**
+         * @brief       Constructs a new BenchmarkObject.
+         *
+         * @param[in]   value the value of the object.
+         */
+        explicit BenchmarkObject(int value) :
+                m_value(value) {
+
+        }
+
+        /**
+         * @brief       Returns the value of the object.
+         *
+         * @returns     the value.
+         */
+        auto value() const -> int override {
+            return m_value;
+        }
+
+    private:
+        int m_value;
+};
+
+#endif // NEDRYSOFT_COMPONENTSYSTEM_BENCHMARKOBJECT_H
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BenchmarkRunner.h"
+
+#include "BenchmarkObject.h"
+#include "ComponentLoader.h"
+#include "IComponentManager.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <algorithm>
+
+namespace {
+    // the accumulated results of the lookups are written here so that the compiler cannot discard them
+
+    volatile int benchmarkSink = 0;
+}
+
+BenchmarkRunner::BenchmarkRunner(int iterations) :
+        m_iterations(qMax(1, iterations)) {
+
+}
+
+auto BenchmarkRunner::benchmarkTopology(const QString &topology, const QString &folder, bool parallelLoading) -> void {
+    QVector<double> addSamples, loadSamples, unloadSamples;
+    QElapsedTimer timer;
+    int componentCount = 0;
+
+    for (auto iteration = 0; iteration < m_iterations; iteration++) {
+        Nedrysoft::ComponentSystem::ComponentLoader componentLoader;
+
+        componentLoader.setParallelLoading(parallelLoading);
+
+        timer.start();
+
+        componentLoader.addComponents(folder);
+
+        addSamples.append(timer.nsecsElapsed());
+
+        timer.start();
+
+        componentLoader.loadComponents();
+
+        loadSamples.append(timer.nsecsElapsed());
+
+        componentCount = componentLoader.components().count();
+
+        timer.start();
+
+        componentLoader.unloadComponents();
+
+        unloadSamples.append(timer.nsecsElapsed());
+    }
+
+    QJsonObject parameters;
+
+    parameters["topology"] = topology;
+    parameters["components"] = componentCount;
+    parameters["parallelLoading"] = parallelLoading;
+
+    addResult("loader.addComponents", parameters, addSamples);
+    addResult("loader.loadComponents", parameters, loadSamples);
+    addResult("loader.unloadComponents", parameters, unloadSamples);
+}
+
+auto BenchmarkRunner::benchmarkRegistry(int objectCount, int lookupCount) -> void {
+    QVector<double> addSamples, removeSamples, coldSamples, interfaceSamples, classSamples, listSamples;
+    QElapsedTimer timer;
+
+    // getObjects copies the whole list, so fewer lookups are averaged for large registries
+
+    auto listLookupCount = qBound(1, 1000000 / qMax(1, objectCount), lookupCount);
+
+    auto lookupResult = 0;
+
+    for (auto iteration = 0; iteration < m_iterations; iteration++) {
+        QList<QObject *> objects;
+
+        objects.reserve(objectCount);
+
+        for (auto objectIndex = 0; objectIndex < objectCount; objectIndex++) {
+            objects.append(new BenchmarkObject(objectIndex));
+        }
+
+        timer.start();
+
+        Nedrysoft::ComponentSystem::addObjects(objects);
+
+        addSamples.append(timer.nsecsElapsed());
+
+        // the first lookup of a type builds its index entry, the entry outlives the objects so only the lookup
+        // in the first iteration is cold
+
+        timer.start();
+
+        lookupResult += Nedrysoft::ComponentSystem::getObjects<IBenchmarkInterface>().count();
+
+        if (iteration == 0) {
+            coldSamples.append(timer.nsecsElapsed());
+        }
+
+        // the registry does not change during the timed loops, so the lookups are checked once beforehand
+
+        auto objectsFound = ( Nedrysoft::ComponentSystem::getObject<IBenchmarkInterface>() ) &&
+                            ( Nedrysoft::ComponentSystem::getObject<BenchmarkObject>() );
+
+        if (objectsFound) {
+            timer.start();
+
+            for (auto lookupIndex = 0; lookupIndex < lookupCount; lookupIndex++) {
+                lookupResult += Nedrysoft::ComponentSystem::getObject<IBenchmarkInterface>()->value();
+            }
+
+            interfaceSamples.append(static_cast<double>(timer.nsecsElapsed()) / lookupCount);
+
+            timer.start();
+
+            for (auto lookupIndex = 0; lookupIndex < lookupCount; lookupIndex++) {
+                lookupResult += Nedrysoft::ComponentSystem::getObject<BenchmarkObject>()->value();
+            }
+
+            classSamples.append(static_cast<double>(timer.nsecsElapsed()) / lookupCount);
+        }
+
+        timer.start();
+
+        for (auto lookupIndex = 0; lookupIndex < listLookupCount; lookupIndex++) {
+            lookupResult += Nedrysoft::ComponentSystem::getObjects<IBenchmarkInterface>().count();
+        }
+
+        listSamples.append(static_cast<double>(timer.nsecsElapsed()) / listLookupCount);
+
+        timer.start();
+
+        Nedrysoft::ComponentSystem::removeObjects(objects);
+
+        removeSamples.append(timer.nsecsElapsed());
+
+        qDeleteAll(objects);
+    }
+
+    benchmarkSink = lookupResult;
+
+    QJsonObject parameters;
+
+    parameters["objects"] = objectCount;
+
+    addResult("registry.addObjects", parameters, addSamples);
+    addResult("registry.removeObjects", parameters, removeSamples);
+    addResult("registry.getObjects.cold", parameters, coldSamples);
+    addResult("registry.getObject.interface", parameters, interfaceSamples);
+    addResult("registry.getObject.class", parameters, classSamples);
+    addResult("registry.getObjects.interface", parameters, listSamples);
+}
+
+auto BenchmarkRunner::results() const -> QJsonObject {
+    QJsonObject context;
+
+    context["date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    context["qtVersion"] = QString::fromLatin1(qVersion());
+    context["idealThreadCount"] = QThread::idealThreadCount();
+    context["iterations"] = m_iterations;
+#if defined(QT_DEBUG)
+    context["buildType"] = "debug";
+#else
+    context["buildType"] = "release";
+#endif
+
+    QJsonObject resultsObject;
+
+    resultsObject["context"] = context;
+    resultsObject["benchmarks"] = m_results;
+
+    return resultsObject;
+}
+
+auto BenchmarkRunner::addResult(const QString &name, const QJsonObject &parameters, QVector<double> samples) -> void {
+    if (samples.isEmpty()) {
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    double total = 0;
+
+    for (auto sample : samples) {
+        total += sample;
+    }
+
+    auto middle = samples.count() / 2;
+    auto median = ( samples.count() % 2 ) ? samples.at(middle) : ( samples.at(middle - 1) + samples.at(middle) ) / 2;
+
+    QJsonObject result;
+
+    result["name"] = name;
+    result["parameters"] = parameters;
+    result["unit"] = "ns";
+    result["samples"] = samples.count();
+    result["min"] = samples.first();
+    result["max"] = samples.last();
+    result["mean"] = total / samples.count();
+    result["median"] = median;
+
+    m_results.append(result);
+}
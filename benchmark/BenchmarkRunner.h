@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_COMPONENTSYSTEM_BENCHMARKRUNNER_H
+#define NEDRYSOFT_COMPONENTSYSTEM_BENCHMARKRUNNER_H
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief       The BenchmarkRunner runs the component system benchmarks and collects the results.
+ *
+ * @details     Every benchmark is run for a number of iterations, the result of a benchmark contains the
+ *              minimum, maximum, mean and median of the samples in nanoseconds.
+ */
+class BenchmarkRunner {
+    public:
+        /**
+         * @brief       Constructs a new BenchmarkRunner.
+         *
+         * @param[in]   iterations the number of times each benchmark is run.
+         */
+        explicit BenchmarkRunner(int iterations);
+
+        /**
+         * @brief       Measures addComponents, loadComponents and unloadComponents end to end.
+         *
+         * @details     A new ComponentLoader is used for every iteration.
+         *
+         * @param[in]   topology the name of the topology being measured.
+         * @param[in]   folder the folder containing the components of the topology.
+         * @param[in]   parallelLoading true if the loader should load libraries concurrently; otherwise false.
+         */
+        auto benchmarkTopology(const QString &topology, const QString &folder, bool parallelLoading) -> void;
+
+        /**
+         * @brief       Measures registry insertion, removal and lookups.
+         *
+         * @param[in]   objectCount the number of objects in the registry.
+         * @param[in]   lookupCount the number of lookups that are averaged for each sample.
+         */
+        auto benchmarkRegistry(int objectCount, int lookupCount) -> void;
+
+        /**
+         * @brief       Returns the results of the benchmarks that have been run.
+         *
+         * @returns     the results.
+         */
+        auto results() const -> QJsonObject;
+
+    private:
+        /**
+         * @brief       Adds the result of a benchmark.
+         *
+         * @param[in]   name the name of the benchmark.
+         * @param[in]   parameters the parameters the benchmark was run with.
+         * @param[in]   samples the samples in nanoseconds.
+         */
+        auto addResult(const QString &name, const QJsonObject &parameters, QVector<double> samples) -> void;
+
+    private:
+        int m_iterations;
+        QJsonArray m_results;
+};
+
+#endif // NEDRYSOFT_COMPONENTSYSTEM_BENCHMARKRUNNER_H
@@ -0,0 +1,118 @@
+#
+# Copyright (C) 2020 Adrian Carpenter
+#
+# This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+#
+# A cross-platform plugin system for Qt applications.
+#
+# Created on 14/10/2026.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+
+# generate_benchmark_components(topology count targets)
+#
+# Generates count synthetic component libraries whose dependencies form the given topology, the libraries are
+# written to ${BENCHMARK_COMPONENT_DIR}/<topology> and the names of the created targets are returned in targets.
+#
+#   Chain   - every component depends on the previous component.
+#   FanOut  - every component depends on the first component.
+#   Diamond - a sequence of diamonds, two components depend on the top of the diamond and the bottom of the
+#             diamond depends on both of them, the bottom is the top of the next diamond.
+#   Random  - every component depends on up to NEDRYSOFT_COMPONENTSYSTEM_BENCHMARK_MAX_DEPENDENCIES randomly
+#             chosen earlier components, which is always a DAG.
+
+function(generate_benchmark_components topology count targets)
+    set(created_TARGETS "")
+
+    math(EXPR lastIndex "${count}-1")
+
+    foreach(index RANGE ${lastIndex})
+        set(dependencies "")
+
+        if(index GREATER 0)
+            if(topology STREQUAL "Chain")
+                math(EXPR dependency "${index}-1")
+                list(APPEND dependencies ${dependency})
+            elseif(topology STREQUAL "FanOut")
+                list(APPEND dependencies 0)
+            elseif(topology STREQUAL "Diamond")
+                math(EXPR diamondTop "((${index}-1)/3)*3")
+                math(EXPR diamondPosition "(${index}-1)%3")
+
+                if(diamondPosition EQUAL 2)
+                    math(EXPR leftDependency "${diamondTop}+1")
+                    math(EXPR rightDependency "${diamondTop}+2")
+                    list(APPEND dependencies ${leftDependency} ${rightDependency})
+                else()
+                    list(APPEND dependencies ${diamondTop})
+                endif()
+            elseif(topology STREQUAL "Random")
+                math(EXPR dependencySeed "${NEDRYSOFT_COMPONENTSYSTEM_BENCHMARK_SEED}*100003+${index}")
+
+                string(RANDOM LENGTH 6 ALPHABET 123456789 RANDOM_SEED ${dependencySeed} randomValue)
+
+                math(EXPR dependencyCount "${randomValue}%${NEDRYSOFT_COMPONENTSYSTEM_BENCHMARK_MAX_DEPENDENCIES}+1")
+
+                foreach(dependencyIndex RANGE 1 ${dependencyCount})
+                    string(RANDOM LENGTH 6 ALPHABET 123456789 randomValue)
+
+                    math(EXPR dependency "${randomValue}%${index}")
+                    list(APPEND dependencies ${dependency})
+                endforeach()
+
+                list(REMOVE_DUPLICATES dependencies)
+            else()
+                message(FATAL_ERROR "Unknown benchmark topology ${topology}")
+            endif()
+        endif()
+
+        set(BENCHMARK_COMPONENT_CLASS "Benchmark${topology}Component${index}")
+        set(BENCHMARK_COMPONENT_DEPENDENCIES "")
+
+        foreach(dependency ${dependencies})
+            if(NOT BENCHMARK_COMPONENT_DEPENDENCIES STREQUAL "")
+                string(APPEND BENCHMARK_COMPONENT_DEPENDENCIES ",")
+            endif()
+
+            string(APPEND BENCHMARK_COMPONENT_DEPENDENCIES
+                   "\n        { \"Name\" : \"Benchmark${topology}Component${dependency}\", \"Version\" : \"1.0.0\" }")
+        endforeach()
+
+        set(componentSourceDir "${CMAKE_CURRENT_BINARY_DIR}/generated/${BENCHMARK_COMPONENT_CLASS}")
+
+        configure_file(BenchmarkComponent.h.in "${componentSourceDir}/${BENCHMARK_COMPONENT_CLASS}.h" @ONLY)
+        configure_file(BenchmarkComponent.cpp.in "${componentSourceDir}/${BENCHMARK_COMPONENT_CLASS}.cpp" @ONLY)
+        configure_file(Metadata.json.in "${componentSourceDir}/Metadata.json" @ONLY)
+
+        add_library(${BENCHMARK_COMPONENT_CLASS} MODULE
+            "${componentSourceDir}/${BENCHMARK_COMPONENT_CLASS}.h"
+            "${componentSourceDir}/${BENCHMARK_COMPONENT_CLASS}.cpp"
+        )
+
+        target_include_directories(${BENCHMARK_COMPONENT_CLASS} PRIVATE "${componentSourceDir}")
+
+        target_link_libraries(${BENCHMARK_COMPONENT_CLASS} ${PROJECT_NAME} ${Qt_LIBS})
+
+        set_target_properties(${BENCHMARK_COMPONENT_CLASS} PROPERTIES
+            LIBRARY_OUTPUT_DIRECTORY "${BENCHMARK_COMPONENT_DIR}/${topology}"
+            RUNTIME_OUTPUT_DIRECTORY "${BENCHMARK_COMPONENT_DIR}/${topology}"
+        )
+
+        list(APPEND created_TARGETS ${BENCHMARK_COMPONENT_CLASS})
+    endforeach()
+
+    set(${targets} ${created_TARGETS} PARENT_SCOPE)
+endfunction()
@@ -23,9 +23,20 @@
 
 #include "Component.h"
 
+#include "IComponentManager.h"
+
+#include <QFile>
 #include <QJsonArray>
 
+#include <mutex>
+
 Nedrysoft::ComponentSystem::Component::Component() :
+        m_canBeDisabled(true),
+        m_isLazy(false),
+        m_concurrentInitialisation(false),
+        m_finaliseOnExit(false),
+        m_staticInstanceFunction(nullptr),
+        m_imageSize(0),
         m_isLoaded(false),
         m_loadFlags(ComponentLoader::Unloaded) {
 
@@ -35,148 +46,268 @@ Nedrysoft::ComponentSystem::Component::Component(const QString &name, const QStr
         m_name(name),
         m_filename(filename),
         m_metadata(metadata),
+        m_canBeDisabled(true),
+        m_isLazy(false),
+        m_concurrentInitialisation(false),
+        m_finaliseOnExit(false),
+        m_staticInstanceFunction(nullptr),
+        m_imageSize(0),
         m_isLoaded(false),
         m_loadFlags(ComponentLoader::Unloaded) {
 
+    parseMetadata();
+}
+
+auto Nedrysoft::ComponentSystem::Component::parseMetadata() -> void {
+    auto componentMetadata = m_metadata["MetaData"].toObject();
+
+    auto componentVersion = componentMetadata["Version"].toString();
+    auto componentBranch = componentMetadata["Branch"].toString();
+    auto componentRevision = componentMetadata["Revision"].toString();
+
+    m_version = QVersionNumber::fromString(componentVersion);
+    m_versionString = QString("%1-%2 (%3)").arg(componentVersion).arg(componentBranch).arg(componentRevision);
+
+    m_category = componentMetadata["Category"].toString();
+    m_vendor = componentMetadata["Vendor"].toString();
+    m_copyright = componentMetadata["Copyright"].toString();
+    m_url = componentMetadata["Url"].toString();
+
+    m_identifier = ( componentMetadata["Name"].toString() + "." + m_vendor ).toLower();
+
+    if (componentMetadata.contains("CanBeDisabled")) {
+        m_canBeDisabled = componentMetadata["CanBeDisabled"].toBool();
+    }
+
+    m_isLazy = componentMetadata["Activation"].toString().compare("Lazy", Qt::CaseInsensitive) == 0;
+    m_concurrentInitialisation = componentMetadata["ConcurrentInitialisation"].toBool();
+    m_finaliseOnExit = componentMetadata["FinaliseOnExit"].toBool();
+
+    for (auto object : componentMetadata["Provides"].toArray()) {
+        m_providedInterfaces.append(object.toString());
+    }
+
+    for (auto object : componentMetadata["Consumes"].toArray()) {
+        m_consumedInterfaces.append(object.toString());
+    }
+
+    auto dependencies = componentMetadata["Dependencies"].toArray();
+
+    m_dependencyRequirements.reserve(dependencies.count());
+
+    for (auto object : dependencies) {
+        auto dependency = object.toObject();
+
+        m_dependencyRequirements.append(DependencyRequirement{
+                dependency["Name"].toString(),
+                QVersionNumber::fromString(dependency["Version"].toString()),
+                dependency["Version"].toString() });
+    }
+
+    // the multi-line text fields are only joined when they are first needed
+
+    m_licenseLines = componentMetadata["License"].toArray();
+    m_descriptionLines = componentMetadata["Description"].toArray();
 }
 
 void Nedrysoft::ComponentSystem::Component::addDependency(Component *dependency, QVersionNumber versionNumber) {
-    m_dependencyVersions[dependency] = std::move(versionNumber);
     m_dependencies.append(dependency);
+    m_dependencyVersions.append(std::move(versionNumber));
+
+    dependency->m_dependents.append(this);
+}
+
+auto Nedrysoft::ComponentSystem::Component::removeDependencies() -> void {
+    for (auto dependency : m_dependencies) {
+        dependency->m_dependents.removeAll(this);
+    }
+
+    m_dependencies.clear();
+    m_dependencyVersions.clear();
+}
+
+auto Nedrysoft::ComponentSystem::Component::dependents() const -> QList<Nedrysoft::ComponentSystem::Component *> {
+    return m_dependents;
+}
+
+auto Nedrysoft::ComponentSystem::Component::imageSize() const -> qint64 {
+#if defined(Q_OS_LINUX)
+    if (!m_isLoaded || isStatic()) {
+        return 0;
+    }
+
+    return m_imageSize;
+#else
+    return -1;
+#endif
+}
+
+auto Nedrysoft::ComponentSystem::Component::registeredObjectCount() const -> int {
+    return IComponentManager::getInstance()->ownedObjectCount(this);
+}
+
+auto Nedrysoft::ComponentSystem::Component::mappedImageSizes() -> QHash<QString, qint64> {
+    QHash<QString, qint64> imageSizes;
+
+#if defined(Q_OS_LINUX)
+    // each line is "start-end perms offset dev inode path", only file mappings have a path
+
+    QFile mapsFile("/proc/self/maps");
+
+    if (!mapsFile.open(QFile::ReadOnly | QFile::Text)) {
+        return imageSizes;
+    }
+
+    while (!mapsFile.atEnd()) {
+        auto mapping = mapsFile.readLine().trimmed();
+        auto pathIndex = mapping.indexOf('/');
+        auto rangeSeparator = mapping.indexOf('-');
+        auto rangeEnd = mapping.indexOf(' ');
+
+        if (( pathIndex < 0 ) || ( rangeSeparator < 0 ) || ( rangeEnd < rangeSeparator )) {
+            continue;
+        }
+
+        bool startValid = false, endValid = false;
+
+        auto mappingStart = mapping.left(rangeSeparator).toULongLong(&startValid, 16);
+        auto mappingEnd = mapping.mid(rangeSeparator+1, rangeEnd-rangeSeparator-1).toULongLong(&endValid, 16);
+
+        if (startValid && endValid && ( mappingEnd > mappingStart )) {
+            imageSizes[QString::fromLocal8Bit(mapping.mid(pathIndex))] += static_cast<qint64>(mappingEnd-mappingStart);
+        }
+    }
+#endif
+
+    return imageSizes;
 }
 
-auto Nedrysoft::ComponentSystem::Component::name() -> QString {
+auto Nedrysoft::ComponentSystem::Component::name() const -> QString {
     return m_name;
 }
 
-auto Nedrysoft::ComponentSystem::Component::filename() -> QString {
+auto Nedrysoft::ComponentSystem::Component::filename() const -> QString {
     return m_filename;
 }
 
-auto Nedrysoft::ComponentSystem::Component::metadata() -> QJsonObject  {
+auto Nedrysoft::ComponentSystem::Component::metadata() const -> QJsonObject  {
     return m_metadata;
 }
 
-auto Nedrysoft::ComponentSystem::Component::isLoaded() -> bool {
+auto Nedrysoft::ComponentSystem::Component::isLoaded() const -> bool {
     return m_isLoaded;
 }
 
-auto Nedrysoft::ComponentSystem::Component::loadStatus() ->int {
+auto Nedrysoft::ComponentSystem::Component::loadStatus() const -> int {
     return m_loadFlags;
 }
 
-auto Nedrysoft::ComponentSystem::Component::missingDependencies() -> QStringList {
+auto Nedrysoft::ComponentSystem::Component::missingDependencies() const -> QStringList {
     return m_missingDependencies;
 }
 
-auto Nedrysoft::ComponentSystem::Component::version() -> QVersionNumber {
-    auto componentMetadata = m_metadata["MetaData"].toObject();
-    auto componentVersion = componentMetadata["Version"].toString();
-
-    return QVersionNumber::fromString(componentVersion);
+auto Nedrysoft::ComponentSystem::Component::version() const -> QVersionNumber {
+    return m_version;
 }
 
-auto Nedrysoft::ComponentSystem::Component::versionString() -> QString {
-    auto componentMetadata = m_metadata["MetaData"].toObject();
-    auto componentVersion = componentMetadata["Version"].toString();
-    auto componentBranch = componentMetadata["Branch"].toString();
-    auto componentRevision = componentMetadata["Revision"].toString();
-
-    return QString("%1-%2 (%3)").arg(componentVersion).arg(componentBranch).arg(componentRevision);
+auto Nedrysoft::ComponentSystem::Component::versionString() const -> QString {
+    return m_versionString;
 }
 
-auto Nedrysoft::ComponentSystem::Component::identifier() -> QString {
-    auto componentMetadata = m_metadata["MetaData"].toObject();
-
-    return ( componentMetadata["Name"].toString() + "." + componentMetadata["Vendor"].toString()).toLower();
+auto Nedrysoft::ComponentSystem::Component::identifier() const -> QString {
+    return m_identifier;
 }
 
-auto Nedrysoft::ComponentSystem::Component::category() -> QString {
-    auto componentMetadata = m_metadata["MetaData"].toObject();
-
-    return componentMetadata["Category"].toString();
+auto Nedrysoft::ComponentSystem::Component::category() const -> QString {
+    return m_category;
 }
 
-auto Nedrysoft::ComponentSystem::Component::vendor() -> QString {
-    auto componentMetadata = m_metadata["MetaData"].toObject();
-
-    return componentMetadata["Vendor"].toString();
+auto Nedrysoft::ComponentSystem::Component::vendor() const -> QString {
+    return m_vendor;
 }
 
-auto Nedrysoft::ComponentSystem::Component::license() -> QString {
-    QString licenseText;
-    auto componentMetadata = m_metadata["MetaData"].toObject();
-
-    auto licenseContent = componentMetadata["License"].toArray();
+auto Nedrysoft::ComponentSystem::Component::license() const -> QString {
+    joinText();
 
-    for (auto object : licenseContent) {
-        licenseText += object.toString();
-    }
+    return m_license;
+}
 
-    return licenseText;
+auto Nedrysoft::ComponentSystem::Component::copyright() const -> QString {
+    return m_copyright;
 }
 
-auto Nedrysoft::ComponentSystem::Component::copyright() -> QString {
-    auto componentMetadata = m_metadata["MetaData"].toObject();
+auto Nedrysoft::ComponentSystem::Component::description() const -> QString {
+    joinText();
 
-    return componentMetadata["Copyright"].toString();
+    return m_description;
 }
 
-auto Nedrysoft::ComponentSystem::Component::description() -> QString {
-    QString descriptionText;
-    auto componentMetadata = m_metadata["MetaData"].toObject();
+auto Nedrysoft::ComponentSystem::Component::url() const -> QString {
+    return m_url;
+}
 
-    auto licenseContent = componentMetadata["Description"].toArray();
+auto Nedrysoft::ComponentSystem::Component::dependencies() const -> QString {
+    joinText();
 
-    for (auto object : licenseContent) {
-        descriptionText += object.toString() + "\r\n";
-    }
-
-    return descriptionText;
+    return m_dependencyText;
 }
 
-auto Nedrysoft::ComponentSystem::Component::url() -> QString {
-    auto componentMetadata = m_metadata["MetaData"].toObject();
+auto Nedrysoft::ComponentSystem::Component::canBeDisabled() const -> bool {
+    return m_canBeDisabled;
+}
 
-    return componentMetadata["Url"].toString();
+auto Nedrysoft::ComponentSystem::Component::isLazy() const -> bool {
+    return m_isLazy;
 }
 
-auto Nedrysoft::ComponentSystem::Component::dependencies() -> QString {
-    QString dependencyText;
-    auto componentMetadata = m_metadata["MetaData"].toObject();
+auto Nedrysoft::ComponentSystem::Component::hasConcurrentInitialisation() const -> bool {
+    return m_concurrentInitialisation;
+}
 
-    auto licenseContent = componentMetadata["Dependencies"].toArray();
+auto Nedrysoft::ComponentSystem::Component::isStatic() const -> bool {
+    return m_staticInstanceFunction != nullptr;
+}
 
-    for (auto object : licenseContent) {
-        auto dependency = object.toObject();
+auto Nedrysoft::ComponentSystem::Component::finalisesOnExit() const -> bool {
+    return m_finaliseOnExit;
+}
 
-        dependencyText += QString("%1 (%2)\r\n").arg(dependency["Name"].toString()).arg(
-                dependency["Version"].toString());
-    }
+auto Nedrysoft::ComponentSystem::Component::providedInterfaces() const -> QStringList {
+    return m_providedInterfaces;
+}
 
-    return dependencyText;
+auto Nedrysoft::ComponentSystem::Component::consumedInterfaces() const -> QStringList {
+    return m_consumedInterfaces;
 }
 
-auto Nedrysoft::ComponentSystem::Component::canBeDisabled() -> bool {
-    auto componentMetadata = m_metadata["MetaData"].toObject();
+auto Nedrysoft::ComponentSystem::Component::joinText() const -> void {
+    // the text may be requested from several threads at once, only the first caller joins it
 
-    if (componentMetadata.contains("CanBeDisabled")) {
-        return componentMetadata["CanBeDisabled"].toBool();
-    }
+    std::call_once(m_textJoined, [this]() {
+        for (auto object : m_licenseLines) {
+            m_license += object.toString();
+        }
+
+        for (auto object : m_descriptionLines) {
+            m_description += object.toString() + "\r\n";
+        }
 
-    return true;
+        for (const auto &dependency : m_dependencyRequirements) {
+            m_dependencyText += QString("%1 (%2)\r\n").arg(dependency.name).arg(dependency.versionText);
+        }
+    });
 }
 
 auto Nedrysoft::ComponentSystem::Component::validateDependencies() -> void {
-    for (auto dependency : m_dependencies) {
+    for (auto dependencyIndex = 0; dependencyIndex < m_dependencies.count(); dependencyIndex++) {
+        auto dependency = m_dependencies.at(dependencyIndex);
+
         if (!dependency->isLoaded()) {
             m_loadFlags |= Nedrysoft::ComponentSystem::ComponentLoader::MissingDependency;
         } else {
-            if (dependency->version() < m_dependencyVersions[dependency]) {
+            if (dependency->version() < m_dependencyVersions.at(dependencyIndex)) {
                 m_loadFlags |= Nedrysoft::ComponentSystem::ComponentLoader::IncompatibleVersion;
             }
         }
     }
 }
-
-
@@ -28,16 +28,25 @@
 #include "ComponentLoader.h"
 
 #include <QDataStream>
+#include <QHash>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QList>
-#include <QMap>
+#include <QPointer>
 #include <QString>
+#include <QStringList>
+#include <QVector>
 #include <QVersionNumber>
+#include <QtPlugin>
+#include <mutex>
 
 namespace Nedrysoft { namespace ComponentSystem {
     /**
      * @brief       The Component class holds the information about a discovered component.
      *
+     * @details     The metadata is decoded once when the component is created, the accessors return the
+     *              decoded values without walking the JSON metadata.
+     *
      * @class       Nedrysoft::ComponentSystem::Component Component.h <Component>
      */
     class COMPONENT_SYSTEM_DLLSPEC Component {
@@ -69,7 +78,7 @@ namespace Nedrysoft { namespace ComponentSystem {
              *
              * @returns     the component name.
              */
-            auto name() -> QString;
+            auto name() const -> QString;
 
             /**
              * @brief       Returns the file name of the component.
@@ -77,14 +86,14 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     the component filename.
              *
              */
-            auto filename() -> QString;
+            auto filename() const -> QString;
 
             /**
              * @brief       Returns the decoded metadata for the component as a JSON object.
              *
              * @returns     The component metadata.
              */
-            auto metadata() -> QJsonObject;
+            auto metadata() const -> QJsonObject;
 
             /**
              * @brief       Returns where the component could be loaded.
@@ -95,7 +104,7 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     true if the component is loaded; otherwise false.
              *
              */
-            auto isLoaded() -> bool;
+            auto isLoaded() const -> bool;
 
             /**
              * @brief       Returns the load status of the component.
@@ -105,7 +114,7 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     the bit field containing information about the load state of the component.
              *
              */
-            auto loadStatus() -> int;
+            auto loadStatus() const -> int;
 
             /**
              * @brief       Returns a list of missing dependencies.
@@ -115,21 +124,21 @@ namespace Nedrysoft { namespace ComponentSystem {
              *
              * @returns     The list of missing dependencies.
              */
-            auto missingDependencies() -> QStringList;
+            auto missingDependencies() const -> QStringList;
 
             /**
              * @brief       Returns the version of the component.
              *
              * @returns     the component version.
              */
-            auto version() -> QVersionNumber;
+            auto version() const -> QVersionNumber;
 
             /**
              * @brief       Returns the version of the component as a formatted string.
              *
              * @returns     the formatted version string.
              */
-            auto versionString() -> QString;
+            auto versionString() const -> QString;
 
             /**
              * @brief       Returns the reverse dns identifier of the component.
@@ -137,14 +146,14 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     the identifier.
              *
              */
-            auto identifier() -> QString;
+            auto identifier() const -> QString;
 
             /**
              * @brief       Returns the category that this component belongs to.
              *
              * @returns     the category of the component.
              */
-            auto category() -> QString;
+            auto category() const -> QString;
 
             /**
              * @brief       Returns the vendor of the component.
@@ -152,14 +161,14 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     the vendor.
              *
              */
-            auto vendor() -> QString;
+            auto vendor() const -> QString;
 
             /**
              * @brief       Returns the license text of the component.
              *
              * @returns     the license text.
              */
-            auto license() -> QString;
+            auto license() const -> QString;
 
             /**
              * @brief       Returns the copyright information for the component.
@@ -167,7 +176,7 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     the copyright text.
              *
              */
-            auto copyright() -> QString;
+            auto copyright() const -> QString;
 
             /**
              * @brief       Returns the description of the component.
@@ -175,7 +184,7 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     the description text.
              *
              */
-            auto description() -> QString;
+            auto description() const -> QString;
 
             /**
              * @brief       Returns the url for the component.
@@ -183,7 +192,7 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     the URL.
              *
              */
-            auto url() -> QString;
+            auto url() const -> QString;
 
             /**
              * @brief       Returns the list of dependencies as a string.
@@ -191,7 +200,7 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     the dependencies.
              *
              */
-            auto dependencies() -> QString;
+            auto dependencies() const -> QString;
 
             /**
              * @brief       Returns whether the component can be disabled or not.
@@ -201,7 +210,111 @@ namespace Nedrysoft { namespace ComponentSystem {
              * @returns     true if the component can be disabled; otherwise false.
              *
              */
-            auto canBeDisabled() -> bool;
+            auto canBeDisabled() const -> bool;
+
+            /**
+             * @brief       Returns whether the component is activated on demand.
+             *
+             * @details     A component declares on demand activation by setting "Activation" to "Lazy" in its
+             *              metadata, the loader then defers loading the component until an object implementing
+             *              one of the interfaces that it provides is requested from the registry.
+             *
+             * @returns     true if the component is activated on demand; otherwise false.
+             */
+            auto isLazy() const -> bool;
+
+            /**
+             * @brief       Returns whether the initialiseEvent of the component may run concurrently.
+             *
+             * @details     A component opts in by setting "ConcurrentInitialisation" to true in its metadata, its
+             *              initialiseEvent may then be called on a worker thread at the same time as the
+             *              initialiseEvent of other components at the same dependency level.
+             *
+             * @returns     true if the component can be initialised concurrently; otherwise false.
+             */
+            auto hasConcurrentInitialisation() const -> bool;
+
+            /**
+             * @brief       Returns whether the component is linked statically into the application.
+             *
+             * @details     Static components are imported with Q_IMPORT_PLUGIN and added to the loader with
+             *              ComponentLoader::addStaticComponents, they do not have a library file.
+             *
+             * @returns     true if the component is static; otherwise false.
+             */
+            auto isStatic() const -> bool;
+
+            /**
+             * @brief       Returns whether the component must be finalised when the application exits quickly.
+             *
+             * @details     A component sets "FinaliseOnExit" to true in its metadata if its finaliseEvent must be
+             *              called even when the loader is in fast exit mode, for example to flush data to disk.
+             *
+             * @returns     true if the component is finalised in fast exit mode; otherwise false.
+             */
+            auto finalisesOnExit() const -> bool;
+
+            /**
+             * @brief       Returns the list of interfaces that the component provides.
+             *
+             * @details     The interfaces are declared using their IIDs in the "Provides" array of the metadata.
+             *
+             * @returns     the list of interface IIDs.
+             */
+            auto providedInterfaces() const -> QStringList;
+
+            /**
+             * @brief       Returns the list of interfaces that the component consumes.
+             *
+             * @details     The interfaces are declared using their IIDs in the "Consumes" array of the metadata,
+             *              the providers of these interfaces are activated along with the component.
+             *
+             * @returns     the list of interface IIDs.
+             */
+            auto consumedInterfaces() const -> QStringList;
+
+            /**
+             * @brief       Returns the components that depend on this component.
+             *
+             * @details     The reverse of the dependency graph, a loaded component can only be unloaded along with
+             *              the components that depend on it.
+             *
+             * @returns     the list of dependent components.
+             */
+            auto dependents() const -> QList<Nedrysoft::ComponentSystem::Component *>;
+
+            /**
+             * @brief       Returns the size of the memory mapped image of the component library.
+             *
+             * @details     The size is the total of the mappings of the library file in the process, which the
+             *              loader reads from /proc/self/maps once after the component has been loaded.  Static
+             *              components are part of the application image and report 0.
+             *
+             * @returns     the mapped size in bytes, 0 if the component is not loaded or -1 if the size is not
+             *              available on this platform.
+             */
+            auto imageSize() const -> qint64;
+
+            /**
+             * @brief       Returns the number of objects that the component has in the registry.
+             *
+             * @details     Objects are attributed to the component if they are added to the registry while the
+             *              component handles its initialiseEvent or initialisationFinishedEvent, and owner tracking
+             *              has been enabled with IComponentManager::setOwnerTrackingEnabled.
+             *
+             * @returns     the number of registered objects.
+             */
+            auto registeredObjectCount() const -> int;
+
+            /**
+             * @brief       Returns the mapped size of every file mapped into the process.
+             *
+             * @details     Reads /proc/self/maps once, use this rather than imageSize when the sizes of many
+             *              components are needed.
+             *
+             * @returns     the mapped size in bytes for each canonical filename, empty if not available.
+             */
+            static auto mappedImageSizes() -> QHash<QString, qint64>;
 
             /**
              * @brief       Validates the dependencies.
@@ -213,17 +326,70 @@ namespace Nedrysoft { namespace ComponentSystem {
 
             friend class ComponentLoader;
 
+        private:
+            /**
+             * @brief       Decodes the metadata into the typed members.
+             */
+            auto parseMetadata() -> void;
+
+            /**
+             * @brief       Joins the multi-line text fields the first time that one of them is requested.
+             *
+             * @note        This function is thread safe.
+             */
+            auto joinText() const -> void;
+
+            /**
+             * @brief       Removes all dependency edges from this component.
+             *
+             * @details     The component is also removed from the dependents of each of its dependencies.
+             */
+            auto removeDependencies() -> void;
+
         private:
             //! @cond
 
+            struct DependencyRequirement {
+                QString name;
+                QVersionNumber version;
+                QString versionText;
+            };
+
             QString m_name;
             QString m_filename;
             QList<Nedrysoft::ComponentSystem::Component *> m_dependencies;
+            QList<Nedrysoft::ComponentSystem::Component *> m_dependents;
             QJsonObject m_metadata;
+
+            QVersionNumber m_version;
+            QString m_versionString;
+            QString m_identifier;
+            QString m_category;
+            QString m_vendor;
+            QString m_copyright;
+            QString m_url;
+            bool m_canBeDisabled;
+            bool m_isLazy;
+            bool m_concurrentInitialisation;
+            bool m_finaliseOnExit;
+            QtPluginInstanceFunction m_staticInstanceFunction;
+            QPointer<QObject> m_staticInstance;
+            QStringList m_providedInterfaces;
+            QStringList m_consumedInterfaces;
+            QVector<DependencyRequirement> m_dependencyRequirements;
+            qint64 m_imageSize;
+
+            QJsonArray m_licenseLines;
+            QJsonArray m_descriptionLines;
+            mutable QString m_license;
+            mutable QString m_description;
+            mutable QString m_dependencyText;
+            mutable std::once_flag m_textJoined;
+
             bool m_isLoaded;
             Nedrysoft::ComponentSystem::ComponentLoader::LoadFlags m_loadFlags;
             QList<QString> m_missingDependencies;
-            QMap<Nedrysoft::ComponentSystem::Component *, QVersionNumber> m_dependencyVersions;
+            QVector<QVersionNumber> m_dependencyVersions;
 
             //! @endcond
     };
@@ -26,17 +26,42 @@
 #include "ComponentLoader.h"
 
 #include "Component.h"
+#include "ComponentManifest.h"
+#include "ComponentMetadataCache.h"
+#include "ComponentSystemLogging.h"
 #include "IComponent.h"
+#include "IComponentManager.h"
 
+#include <QAtomicInt>
+#include <QCoreApplication>
 #include <QDirIterator>
+#include <QEvent>
+#include <QFileSystemWatcher>
+#include <QFileInfo>
+#include <QHash>
 #include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QLibrary>
 #include <QLibraryInfo>
 #include <QMap>
 #include <QMetaEnum>
+#include <QMutexLocker>
 #include <QPluginLoader>
-
-#include "spdlog.h"
+#include <QSet>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <new>
+#include <vector>
 
 constexpr unsigned int QtMajorBitMask = 0xFFFF0000;
 constexpr unsigned int QtMajorBitShift = 16;
@@ -44,322 +69,2200 @@ constexpr unsigned int QtMinorBitMask = 0x0000FF00;
 constexpr unsigned int QtMinorBitShift = 8;
 constexpr unsigned int QtPatchBitMask = 0x000000FF;
 constexpr unsigned int QtPatchBitShift = 0;
+constexpr double NanosecondsPerMicrosecond = 1000.0;
+constexpr int RescanDelay = 500;                 // milliseconds
+
+namespace Nedrysoft { namespace ComponentSystem {
+    /**
+     * @brief       The ComponentArena owns the components created by a ComponentLoader.
+     *
+     * @details     A deque never moves its elements, so the components (and the dependency edges between them)
+     *              remain valid as more components are added, and the components are allocated in blocks rather
+     *              than individually.  The slots of released components are reset to an empty component and
+     *              kept on a free list, so that rescans and rejected snapshots reuse them rather than growing the
+     *              arena.
+     */
+    struct ComponentArena {
+        std::deque<Nedrysoft::ComponentSystem::Component> components;
+        std::vector<Nedrysoft::ComponentSystem::Component *> freeComponents;
+    };
+
+    /**
+     * @brief       The AsyncLoad holds the state of an asynchronous load as it is handed between the worker and
+     *              the loader thread.
+     *
+     * @details     Each stage of the load runs on one thread and hands the state to the next stage by posting it,
+     *              so the state is never accessed by two threads at once.  Plugin loaders that were not handed to
+     *              a component (because the load was cancelled) are deleted with the state.
+     */
+    struct AsyncLoad {
+        ~AsyncLoad() {
+            qDeleteAll(pluginLoaders);
+        }
 
-Nedrysoft::ComponentSystem::ComponentLoader::ComponentLoader(QObject *parent) :
-        QObject(parent) {
+        QStringList componentFolders;
+        int firstLoadIndex = 0;
+        QList<QFileInfo> candidateFiles;
+        QVector<QJsonObject> candidateMetadata;
+        QList<Nedrysoft::ComponentSystem::Component *> resolvedLoadList;
+        std::function<bool(Nedrysoft::ComponentSystem::Component *)> loadFunction;
+        QVector<QPluginLoader *> pluginLoaders;
+        QVector<bool> loadRequired;
+        QVector<bool> libraryLoaded;
+        QList<QList<int> > waves;
+        int progressCount = 0;
+    };
+}}
+
+namespace {
+    /**
+     * @brief       Returns the version of the qt libraries that the application is using.
+     *
+     * @returns     the qt version.
+     */
+    auto currentQtVersion() -> QVersionNumber {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+        return QLibraryInfo::version();
+#else
+        return QVersionNumber::fromString(qVersion());
+#endif
+    }
+
+    /**
+     * @brief       The ParallelTask class wraps a function so that it can be run on a QThreadPool.
+     */
+    class ParallelTask :
+            public QRunnable {
+
+        public:
+            /**
+             * @brief       Constructs a new ParallelTask that runs the given function.
+             *
+             * @param[in]   function the function to run.
+             */
+            explicit ParallelTask(std::function<void()> function) :
+                    m_function(std::move(function)) {
+
+            }
+
+            /**
+             * @brief       Runs the function.
+             */
+            auto run() -> void override {
+                m_function();
+            }
+
+        private:
+            std::function<void()> m_function;
+    };
+}
 
+Nedrysoft::ComponentSystem::ComponentLoader::ComponentLoader(QObject *parent) :
+        QObject(parent),
+        m_metadataCache(nullptr),
+        m_threadPool(new QThreadPool(this)),
+        m_asyncThreadPool(new QThreadPool(this)),
+        m_parallelLoading(false),
+        m_fastExit(false),
+        m_fileSystemWatcher(nullptr),
+        m_rescanTimer(new QTimer(this)),
+        m_asyncLoading(false),
+        m_componentsLoaded(false),
+        m_providersIndexed(false),
+        m_concurrentInitialisation(false),
+        m_componentArena(new Nedrysoft::ComponentSystem::ComponentArena),
+        m_timingEnabled(0) {
+
+    m_threadPool->setMaxThreadCount(QThread::idealThreadCount());
+    m_asyncThreadPool->setMaxThreadCount(1);
+
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(RescanDelay);
+
+    connect(m_rescanTimer, &QTimer::timeout, this, &Nedrysoft::ComponentSystem::ComponentLoader::rescan);
+
+    m_timer.start();
 }
 
 Nedrysoft::ComponentSystem::ComponentLoader::~ComponentLoader() {
+    // an asynchronous load is cancelled, the worker never waits on the loader thread so it can be waited for here
+    // and the stages that it has already posted are discarded
+
+    m_asyncCancelled.storeRelease(1);
+
+    m_asyncThreadPool->waitForDone();
+
+    QCoreApplication::removePostedEvents(this, QEvent::MetaCall);
+
     unloadComponents();
+
+    delete m_metadataCache;
+
+    // in fast exit mode the components are left for the operating system to reclaim
+
+    if (!m_fastExit) {
+        delete m_componentArena;
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::setMetadataCacheFilename(const QString &filename) -> void {
+    delete m_metadataCache;
+
+    m_metadataCache = nullptr;
+
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    m_metadataCache = new Nedrysoft::ComponentSystem::ComponentMetadataCache(filename);
+
+    m_metadataCache->load();
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::readMetadata(const QFileInfo &fileInfo) -> QJsonObject {
+    auto componentFilename = fileInfo.absoluteFilePath();
+
+    if (!m_metadataCache) {
+        return QPluginLoader(componentFilename).metaData();
+    }
+
+    auto fingerprint = Nedrysoft::ComponentSystem::ComponentFingerprint::fromFile(fileInfo);
+
+    QJsonObject metaDataObject;
+
+    if (m_metadataCache->find(componentFilename, fingerprint, metaDataObject)) {
+        return metaDataObject;
+    }
+
+    metaDataObject = QPluginLoader(componentFilename).metaData();
+
+    m_metadataCache->insert(componentFilename, fingerprint, metaDataObject);
+
+    return metaDataObject;
 }
 
 auto Nedrysoft::ComponentSystem::ComponentLoader::addComponents(const QString &componentFolder) -> void {
+    addComponents(QStringList() << componentFolder);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::addComponents(const QStringList &componentFolders) -> void {
+    addComponentFolders(componentFolders);
+
+    discoverComponents(componentFolders);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::addComponentFolders(const QStringList &componentFolders) -> void {
+    for (const auto &componentFolder : componentFolders) {
+        if (m_componentFolders.contains(componentFolder)) {
+            continue;
+        }
+
+        m_componentFolders.append(componentFolder);
+
+        if (m_fileSystemWatcher) {
+            m_fileSystemWatcher->addPath(componentFolder);
+        }
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::discoverComponents(const QStringList &componentFolders) -> void {
+    addCandidateFiles(findCandidateFiles(componentFolders));
+
+    pruneMetadataCache(componentFolders);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::pruneMetadataCache(const QStringList &componentFolders) -> void {
+    if (!m_metadataCache) {
+        return;
+    }
+
+    for (const auto &componentFolder : componentFolders) {
+        m_metadataCache->removeUnused(componentFolder);
+    }
+
+    m_metadataCache->save();
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::findCandidateFiles(
+        const QStringList &componentFolders) -> QList<QFileInfo> {
+
+    QList<QFileInfo> candidateFiles;
+
+    // find the candidate files in each folder, files are sorted so that the results are deterministic
+
+    for (const auto &componentFolder : componentFolders) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("Searching folder for components {}", componentFolder.toStdString());
+
+        QDirIterator dir(componentFolder);
+        QList<QFileInfo> folderFiles;
+
+        while (dir.hasNext()) {
+            dir.next();
+
+            if (!QLibrary::isLibrary(dir.fileInfo().absoluteFilePath())) {
+                continue;
+            }
+
+            folderFiles.append(dir.fileInfo());
+        }
+
+        std::sort(folderFiles.begin(), folderFiles.end(), [](const QFileInfo &left, const QFileInfo &right) {
+            return left.absoluteFilePath() < right.absoluteFilePath();
+        });
+
+        candidateFiles.append(folderFiles);
+    }
+
+    return candidateFiles;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::readCandidateMetadata(
+        const QList<QFileInfo> &candidateFiles) -> QVector<QJsonObject> {
+
+    // read the metadata of every candidate in parallel, the metadata read is I/O bound
+
+    QVector<QJsonObject> candidateMetadata(candidateFiles.count());
+
+    parallelFor(candidateFiles.count(), [this, &candidateFiles, &candidateMetadata](int candidateIndex) {
+        auto startTime = m_timer.nsecsElapsed();
+
+        candidateMetadata[candidateIndex] = readMetadata(candidateFiles.at(candidateIndex));
+
+        recordTiming(candidateFiles.at(candidateIndex).fileName(), LoadPhase::MetadataRead, startTime);
+    });
+
+    return candidateMetadata;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::addCandidateFiles(const QList<QFileInfo> &candidateFiles) -> void {
+    addCandidateFiles(candidateFiles, readCandidateMetadata(candidateFiles));
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::addCandidateFiles(
+        const QList<QFileInfo> &candidateFiles,
+        const QVector<QJsonObject> &candidateMetadata) -> void {
+
+    if (candidateFiles.isEmpty()) {
+        return;
+    }
+
     auto applicationDebugBuild = QLibraryInfo::isDebugBuild();
-#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
-    auto applicationQtVersion = QLibraryInfo::version();
-#else
-    auto applicationQtVersion = QVersionNumber::fromString(qVersion());
-#endif
+    auto applicationQtVersion = currentQtVersion();
 
 #if defined(Q_OS_UNIX) || (( defined(Q_OS_WIN) && defined(__MINGW32__)))
 #if defined(QT_DEBUG)
     if (!applicationDebugBuild) {
-        SPDLOG_WARN(QString("Application was built with QT_DEBUG but has loaded RELEASE qt libraries, component system will load DEBUG components instead.").toStdString());
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_WARN("Application was built with QT_DEBUG but has loaded RELEASE qt libraries, component system will load DEBUG components instead.");
 
         applicationDebugBuild = true;
     }
 #else
     if (applicationDebugBuild) {
-        SPDLOG_WARN(tr("Application was built with QT_NO_DEBUG but has loaded DEBUG qt libraries, component system will load RELEASE components instead.").toStdString());
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_WARN("{}", tr("Application was built with QT_NO_DEBUG but has loaded DEBUG qt libraries, component system will load RELEASE components instead.").toStdString());
 
         applicationDebugBuild = false;
     }
 #endif
 #endif
-    SPDLOG_INFO(QString("Searching folder for components %1").arg(componentFolder).toStdString());
+    // find compatible components, and create a list of components to consider for loading, this is
+    // done in search order so that name clashes are resolved the same way regardless of thread timing
 
-    QDirIterator dir(componentFolder);
+    for (auto candidateIndex = 0; candidateIndex < candidateFiles.count(); candidateIndex++) {
+        auto componentFilename = candidateFiles.at(candidateIndex).absoluteFilePath();
 
-    // find compatible components, and create a list of components to consider for loading
+        m_fileFingerprints[componentFilename] =
+                Nedrysoft::ComponentSystem::ComponentFingerprint::fromFile(candidateFiles.at(candidateIndex));
 
-    while (dir.hasNext()) {
-        dir.next();
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("Found Component {}", componentFilename.toStdString());
 
-        auto componentFilename = dir.fileInfo().absoluteFilePath();
+        auto component = createComponent(
+                componentFilename,
+                candidateMetadata.at(candidateIndex),
+                applicationDebugBuild,
+                applicationQtVersion );
 
-        if (!QLibrary::isLibrary(componentFilename)) {
+        if (!component) {
             continue;
         }
 
-        auto pluginLoader = new QPluginLoader(componentFilename);
+        auto existingComponent = m_componentSearchList.value(component->name());
 
-        SPDLOG_INFO(QString("Found Component %1").arg(componentFilename).toStdString());
+        if (existingComponent) {
+            component->m_loadFlags.setFlag(NameClash);
 
-        auto metaDataObject = pluginLoader->metaData();
+            // a component that is loaded (or waiting to be activated) is never replaced by a rescan
 
-        if (metaDataObject.isEmpty()) {
-            delete pluginLoader;
+            if (existingComponent->m_isLoaded ||
+                existingComponent->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred)) {
 
-            continue;
+                NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                        "component {} was not added. ({})",
+                        component->name().toStdString(),
+                        loadFlagString(component->m_loadFlags).toStdString());
+
+                releaseComponent(component);
+
+                continue;
+            }
         }
 
-        auto componentMetadata = metaDataObject.value("MetaData");
-        auto debugBuild = metaDataObject.value("debug");
-        auto qtVersion = metaDataObject.value("version");
+        m_componentSearchList[component->name()] = component;
+        m_providersIndexed = false;
+    }
+}
 
-        if (debugBuild.isNull() || qtVersion.isNull() || componentMetadata.isNull()) {
-            delete pluginLoader;
+auto Nedrysoft::ComponentSystem::ComponentLoader::addComponentsFromManifest(const QString &filename) -> bool {
+    Nedrysoft::ComponentSystem::ComponentManifest manifest;
 
-            continue;
-        }
+    if (!manifest.read(filename)) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("component manifest {} could not be read.", filename.toStdString());
 
-        if (debugBuild != applicationDebugBuild) {
-            delete pluginLoader;
+        return false;
+    }
 
-            continue;
-        }
+    if (manifest.isStale()) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("component manifest {} is stale.", filename.toStdString());
 
-        auto componentName = componentMetadata.toObject().value("Name");
+        return false;
+    }
 
-        if (componentName.isNull()) {
-            delete pluginLoader;
+    auto applicationDebugBuild = QLibraryInfo::isDebugBuild();
+    auto applicationQtVersion = currentQtVersion();
 
-            continue;
-        }
+#if defined(Q_OS_UNIX) || (( defined(Q_OS_WIN) && defined(__MINGW32__)))
+#if defined(QT_DEBUG)
+    applicationDebugBuild = true;
+#else
+    applicationDebugBuild = false;
+#endif
+#endif
 
-        auto componentQtMajor = static_cast<int>(( qtVersion.toVariant().toUInt() & QtMajorBitMask )
-                >> QtMajorBitShift);
-        auto componentQtMinor = static_cast<int>(( qtVersion.toVariant().toUInt() & QtMinorBitMask )
-                >> QtMinorBitShift);
-        auto componentQtPatch = static_cast<int>(( qtVersion.toVariant().toUInt() & QtPatchBitMask )
-                >> QtPatchBitShift);
+    QStringList componentFolders;
 
-        auto componentQtVersion = QVersionNumber(componentQtMajor, componentQtMinor, componentQtPatch);
+    for (const auto &folder : manifest.folders()) {
+        componentFolders.append(folder.path);
+    }
 
-        auto component = new Nedrysoft::ComponentSystem::Component(
-                componentName.toString(),
-                componentFilename,
-                metaDataObject );
+    addComponentFolders(componentFolders);
 
-        connect(this, &Nedrysoft::ComponentSystem::ComponentLoader::destroyed, [=](QObject *) {
-            delete component;
-        });
+    // the entries are stored in load order, so the order can be used without resolving the dependencies again
 
-        if (componentQtVersion.majorVersion() != applicationQtVersion.majorVersion()) {
-            component->m_loadFlags.setFlag(IncompatibleQtVersion);
+    for (const auto &entry : manifest.entries()) {
+        auto component = createComponent(entry.filename, entry.metadata, applicationDebugBuild, applicationQtVersion);
+
+        // a manifest does not record the inode, the file has just been checked by isStale so the fingerprint that
+        // a rescan compares against is taken from the file
+
+        m_fileFingerprints[entry.filename] =
+                Nedrysoft::ComponentSystem::ComponentFingerprint::fromFile(QFileInfo(entry.filename));
+
+        if (!component) {
+            continue;
         }
 
-        if (m_componentSearchList.contains(componentName.toString())) {
+        if (m_componentSearchList.contains(component->name())) {
             component->m_loadFlags.setFlag(NameClash);
         }
 
-        m_componentSearchList[componentName.toString()] = component;
+        m_componentSearchList[component->name()] = component;
+        m_providersIndexed = false;
 
-        delete pluginLoader;
+        m_manifestLoadOrder.append(component);
     }
+
+    return true;
 }
 
-auto Nedrysoft::ComponentSystem::ComponentLoader::loadComponents(
-        std::function<bool(Nedrysoft::ComponentSystem::Component *)> loadFunction) -> void {
+auto Nedrysoft::ComponentSystem::ComponentLoader::saveManifest(const QString &filename) -> bool {
+    return writeManifest(filename, false);
+}
 
-    QList<Nedrysoft::ComponentSystem::Component *> componentLoadList;
-    QList<Nedrysoft::ComponentSystem::Component *> resolvedLoadList;
+auto Nedrysoft::ComponentSystem::ComponentLoader::saveSnapshot(const QString &filename) -> bool {
+    return writeManifest(filename, true);
+}
 
-    // find and add dependencies from the search
+auto Nedrysoft::ComponentSystem::ComponentLoader::writeManifest(const QString &filename, bool isSnapshot) -> bool {
+    Nedrysoft::ComponentSystem::ComponentManifest manifest;
 
-    auto componentIterator = QMapIterator<QString, Nedrysoft::ComponentSystem::Component *>(m_componentSearchList);
+    manifest.setSnapshot(isSnapshot);
 
-    while (componentIterator.hasNext()) {
-        componentIterator.next();
+    for (const auto &componentFolder : m_componentFolders) {
+        manifest.addFolder(componentFolder);
+    }
 
-        auto component = componentIterator.value();
+    // loaded components first (in load order), then the remaining components in resolved order and finally any
+    // components that cannot be loaded, so that the manifest describes every component that was discovered
 
-        if (component->m_loadFlags) {
-            continue;
-        }
+    QList<Nedrysoft::ComponentSystem::Component *> manifestComponents;
 
-        auto metadata = component->metadata().value("MetaData").toObject();
+    for (const auto &loadedComponent : m_loadOrder) {
+        manifestComponents.append(loadedComponent.second);
+    }
 
-        auto dependencies = metadata.value("Dependencies").toArray();
+    manifestComponents.append(resolveLoadList());
 
-        for (auto dependency : dependencies) {
-            auto dependencyName = dependency.toObject().value("Name").toString();
-            auto dependencyVersion = dependency.toObject().value("Version").toString();
+    QSet<Nedrysoft::ComponentSystem::Component *> orderedComponents;
 
-            if (m_componentSearchList.contains(dependencyName)) {
-                component->addDependency(
-                        m_componentSearchList[dependencyName],
-                        QVersionNumber::fromString(dependencyVersion) );
-            } else {
-                component->m_missingDependencies.append(dependencyName);
-                component->m_loadFlags |= MissingDependency;
-            }
+    for (auto component : manifestComponents) {
+        orderedComponents.insert(component);
+    }
+
+    for (auto component : m_componentSearchList) {
+        if (!orderedComponents.contains(component)) {
+            manifestComponents.append(component);
+        }
+    }
+
+    QStringList disabledComponents;
+
+    for (auto component : manifestComponents) {
+        if (component->isStatic()) {
+            continue;
         }
 
-        if (!component->m_loadFlags) {
-            componentLoadList.append(component);
+        if (component->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::Disabled)) {
+            disabledComponents.append(component->name());
         }
+
+        manifest.addEntry(
+                component->filename(),
+                m_fileFingerprints.value(component->filename()),
+                component->metadata(),
+                isSnapshot ? static_cast<int>(component->m_loadFlags) : 0 );
+    }
+
+    if (isSnapshot) {
+        manifest.setDisabledComponents(disabledComponents);
     }
 
-    // resolve the dependencies to create a load order
+    return manifest.write(filename);
+}
 
-    for (auto current : componentLoadList) {
-        QList<Nedrysoft::ComponentSystem::Component *> dependencyResolveList;
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadSnapshot(
+        const QString &filename,
+        std::function<bool(Nedrysoft::ComponentSystem::Component *)> loadFunction) -> bool {
 
-        if (!resolvedLoadList.contains(current)) {
-            dependencyResolveList.clear();
+    // a snapshot describes every component of the load, so it cannot be combined with other components
 
-            resolve(current, dependencyResolveList);
+    if (!m_componentSearchList.isEmpty()) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("component snapshot {} was not used, components have already been added.",
+                filename.toStdString());
 
-            for (auto dependency : dependencyResolveList) {
-                if (!resolvedLoadList.contains(dependency)) {
-                    resolvedLoadList.append(dependency);
-                }
-            }
-        }
+        return false;
     }
 
-    // load the components that we have satisfied dependencies for
+    Nedrysoft::ComponentSystem::ComponentManifest snapshot;
 
-    for (auto component : resolvedLoadList) {
-        if (component->m_loadFlags) {
-            SPDLOG_INFO(QString("component %1 was not loaded. (%2)").arg(component->name()).arg(loadFlagString(component->m_loadFlags)).toStdString());
+    if (!snapshot.read(filename) || !snapshot.isSnapshot()) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("component snapshot {} could not be read.", filename.toStdString());
 
-            continue;
-        }
+        return false;
+    }
 
-        component->validateDependencies();
+    if (snapshot.isStale()) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("component snapshot {} is stale.", filename.toStdString());
 
-        if (component->m_loadFlags) {
-            SPDLOG_INFO(QString("component %1 was not loaded. (%2)").arg(component->name()).arg(loadFlagString(component->m_loadFlags)).toStdString());
+        return false;
+    }
 
-            continue;
-        }
+    auto applicationDebugBuild = QLibraryInfo::isDebugBuild();
+    auto applicationQtVersion = currentQtVersion();
 
-        if (loadFunction) {
-            if (!loadFunction(component)) {
-                component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Disabled);
+#if defined(Q_OS_UNIX) || (( defined(Q_OS_WIN) && defined(__MINGW32__)))
+#if defined(QT_DEBUG)
+    applicationDebugBuild = true;
+#else
+    applicationDebugBuild = false;
+#endif
+#endif
 
-                SPDLOG_INFO(QString("component %1 was not loaded. (%2)").arg(component->name()).arg(loadFlagString(component->m_loadFlags)).toStdString());
+    // the components are checked against the recorded plan before any of them are added to the loader
 
-                continue;
-            }
-        }
+    auto planFlags = LoadFlags(Loaded | Disabled | Deferred);
 
-        // check if dependencies are loaded, if not then this component cannot be loaded
+    auto snapshotEntries = snapshot.entries();
+    auto recordedDisabled = QSet<QString>();
+    auto currentDisabled = QSet<QString>();
 
-        auto pluginLoader = new QPluginLoader(component->filename());
+    QList<Nedrysoft::ComponentSystem::Component *> snapshotComponents;
 
-        if (!pluginLoader->load()) {
-            component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::UnableToLoad);
+    for (const auto &disabledName : snapshot.disabledComponents()) {
+        recordedDisabled.insert(disabledName);
+    }
 
-            SPDLOG_INFO(QString("component %1 was not loaded. (%2) [%3]").arg(component->name()).arg(loadFlagString(component->m_loadFlags)).arg(pluginLoader->errorString()).toStdString());
+    for (const auto &entry : snapshotEntries) {
+        auto component = createComponent(entry.filename, entry.metadata, applicationDebugBuild, applicationQtVersion);
 
-            delete pluginLoader;
+        if (!component) {
+            releaseComponents(snapshotComponents);
 
-            continue;
+            return false;
         }
 
-        auto componentInterface = qobject_cast<Nedrysoft::ComponentSystem::IComponent *>(pluginLoader->instance());
+        auto recordedFlags = LoadFlags(entry.loadFlags);
 
-        if (!componentInterface) {
-            component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::MissingInterface);
-
-            delete pluginLoader;
+        if (component->m_loadFlags & ~recordedFlags) {
+            NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                    "component snapshot {} was not used, component {} has changed. ({})",
+                    filename.toStdString(),
+                    component->name().toStdString(),
+                    loadFlagString(component->m_loadFlags).toStdString());
 
-            SPDLOG_INFO(QString("component %1 was not loaded. (%2)").arg(component->name()).arg(loadFlagString(component->m_loadFlags)).toStdString());
+            releaseComponent(component);
+            releaseComponents(snapshotComponents);
 
-            continue;
+            return false;
         }
 
-        component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Loaded);
+        // the load function is only consulted for components that could otherwise have been loaded
 
-        m_loadOrder.append(QPair<QPluginLoader *, Component *>(pluginLoader, component));
+        if (loadFunction && !( recordedFlags & ~planFlags ) && !loadFunction(component)) {
+            currentDisabled.insert(component->name());
+        }
 
-        component->m_isLoaded = true;
+        snapshotComponents.append(component);
     }
 
-    // call initialiseEvent for each component (in load order)
+    if (currentDisabled != recordedDisabled) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                "component snapshot {} was not used, the disabled components have changed.",
+                filename.toStdString());
 
-    for (auto componentPair : m_loadOrder) {
-        auto componentInterface = qobject_cast<Nedrysoft::ComponentSystem::IComponent *>(
-                componentPair.first->instance());
+        releaseComponents(snapshotComponents);
 
-        componentInterface->initialiseEvent();
+        return false;
     }
 
-    // call initialisationFinishedEvent for each component (in reverse load order)
+    // the plan is still valid, add the components with their recorded state
 
-    for (auto loadedComponentIterator = m_loadOrder.rbegin();
-         loadedComponentIterator < m_loadOrder.rend(); loadedComponentIterator++) {
-        auto componentInterface = qobject_cast<Nedrysoft::ComponentSystem::IComponent *>(
-                loadedComponentIterator->first->instance());
+    QStringList componentFolders;
 
-        componentInterface->initialisationFinishedEvent();
+    for (const auto &folder : snapshot.folders()) {
+        componentFolders.append(folder.path);
     }
-}
 
-auto Nedrysoft::ComponentSystem::ComponentLoader::components() -> QList<Nedrysoft::ComponentSystem::Component *> {
-    return m_componentSearchList.values();
-}
+    addComponentFolders(componentFolders);
 
-auto Nedrysoft::ComponentSystem::ComponentLoader::resolve(Nedrysoft::ComponentSystem::Component *component,
-        QList<Nedrysoft::ComponentSystem::Component *> &resolvedList) ->void {
+    m_loadFunction = loadFunction;
 
-    QList<Nedrysoft::ComponentSystem::Component *> processedList;
+    for (auto entryIndex = 0; entryIndex < snapshotEntries.count(); entryIndex++) {
+        auto component = snapshotComponents.at(entryIndex);
 
-    resolve(component, resolvedList, processedList);
-}
+        component->m_loadFlags = LoadFlags(snapshotEntries.at(entryIndex).loadFlags) & ~LoadFlags(Loaded);
 
-auto Nedrysoft::ComponentSystem::ComponentLoader::resolve(
-        Nedrysoft::ComponentSystem::Component *component,
-        QList<Nedrysoft::ComponentSystem::Component *> &resolvedList,
-        QList<Nedrysoft::ComponentSystem::Component *> &processedList) -> void {
+        m_fileFingerprints[component->filename()] =
+                Nedrysoft::ComponentSystem::ComponentFingerprint::fromFile(QFileInfo(component->filename()));
+        m_componentSearchList[component->name()] = component;
+    }
 
-    processedList.append(component);
+    m_providersIndexed = false;
 
-    for (auto dependency : component->m_dependencies) {
-        if (!resolvedList.contains(dependency)) {
-            if (processedList.contains(dependency)) {
-                continue;
+    // the dependency edges are still needed for activation and unloading, but they are not validated or resolved
+
+    for (auto component : snapshotComponents) {
+        for (const auto &dependency : component->m_dependencyRequirements) {
+            auto dependencyIterator = m_componentSearchList.constFind(dependency.name);
+
+            if (dependencyIterator != m_componentSearchList.constEnd()) {
+                component->addDependency(dependencyIterator.value(), dependency.version);
+            } else {
+                component->m_missingDependencies.append(dependency.name);
             }
+        }
 
-            resolve(dependency, resolvedList, processedList);
+        if (component->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred)) {
+            addActivators(component);
         }
     }
 
-    resolvedList.append(component);
-}
+    // the entries of the loaded components are stored in load order
 
-auto Nedrysoft::ComponentSystem::ComponentLoader::unloadComponents() -> void {
-    for (auto loadedComponentIterator = m_loadOrder.rbegin();
-        loadedComponentIterator < m_loadOrder.rend(); loadedComponentIterator++) {
+    auto firstLoadIndex = m_loadOrder.count();
 
-        auto pluginLoader = qobject_cast<QPluginLoader *>(loadedComponentIterator->first);
+    for (auto entryIndex = 0; entryIndex < snapshotEntries.count(); entryIndex++) {
+        if (!( snapshotEntries.at(entryIndex).loadFlags & Loaded )) {
+            continue;
+        }
 
-        auto componentInterface = qobject_cast<Nedrysoft::ComponentSystem::IComponent *>(pluginLoader->instance());
+        auto component = snapshotComponents.at(entryIndex);
+
+        // a library that fails to load now prevents its dependents from loading
+
+        auto dependenciesLoaded = std::all_of(
+                component->m_dependencies.begin(),
+                component->m_dependencies.end(),
+                [](Nedrysoft::ComponentSystem::Component *dependency) {
+                    return dependency->m_isLoaded;
+                });
+
+        if (!dependenciesLoaded) {
+            component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::MissingDependency);
+
+            NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                    "component {} was not loaded. ({})",
+                    component->name().toStdString(),
+                    loadFlagString(component->m_loadFlags).toStdString());
 
-        if (!componentInterface) {
             continue;
         }
 
-        componentInterface->finaliseEvent();
+        auto pluginLoader = createPluginLoader(component);
 
-        if (pluginLoader) {
-#if !defined(Q_OS_MACOS)
-            /**
-             * NOTE: calling unload on macOS causes the application to crash, so we leak the memory as it's of no
-             * consequence as all memory will be freed when we exit.  For Windows and Linux we include the unload
-             * for completeness and to stop memory leak analysers reporting a leak.
-             */
-            pluginLoader->unload();
-#endif
-            delete pluginLoader;
-        }
+        instantiateComponent(component, pluginLoader, loadLibrary(component, pluginLoader));
     }
 
-    m_loadOrder.clear();
+    m_componentsLoaded = true;
+
+    initialiseComponents(firstLoadIndex);
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::rescan() -> void {
+    // a rescan only adds to a previous load, a change to a folder before the first load is picked up by the load
+
+    if (( !m_componentsLoaded ) || ( m_asyncLoading )) {
+        return;
+    }
+
+    // files may have been added since the manifest was read, so the dependencies are resolved again
+
+    m_manifestLoadOrder.clear();
+
+    QList<QFileInfo> changedFiles;
+    QSet<QString> currentFiles;
+
+    // find the files that are new or have changed since they were last read
+
+    for (const auto &fileInfo : findCandidateFiles(m_componentFolders)) {
+        auto componentFilename = fileInfo.absoluteFilePath();
+
+        currentFiles.insert(componentFilename);
+
+        auto fingerprintIterator = m_fileFingerprints.constFind(componentFilename);
+
+        if (( fingerprintIterator != m_fileFingerprints.constEnd() ) &&
+            ( fingerprintIterator.value() == Nedrysoft::ComponentSystem::ComponentFingerprint::fromFile(fileInfo) )) {
+
+            continue;
+        }
+
+        if (!retireComponent(componentFilename)) {
+            continue;
+        }
+
+        changedFiles.append(fileInfo);
+    }
+
+    // forget files that have been removed, unless they belong to a loaded component
+
+    for (auto fingerprintIterator = m_fileFingerprints.begin(); fingerprintIterator != m_fileFingerprints.end();) {
+        if (!currentFiles.contains(fingerprintIterator.key()) && retireComponent(fingerprintIterator.key())) {
+            fingerprintIterator = m_fileFingerprints.erase(fingerprintIterator);
+        } else {
+            fingerprintIterator++;
+        }
+    }
+
+    addCandidateFiles(changedFiles);
+
+    if (m_metadataCache) {
+        m_metadataCache->save();
+    }
+
+    // components that were missing a dependency are reconsidered, as the dependency may now be available
+
+    for (auto component : m_componentSearchList) {
+        if (component->m_loadFlags != LoadFlags(MissingDependency)) {
+            continue;
+        }
+
+        component->m_loadFlags = Unloaded;
+        component->m_missingDependencies.clear();
+        component->removeDependencies();
+    }
+
+    // components that were unloaded by unloadComponent keep their flag, so they are not loaded again here
+
+    loadDiscoveredComponents(m_loadFunction);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::retireComponent(const QString &componentFilename) -> bool {
+    for (auto componentIterator = m_componentSearchList.begin();
+         componentIterator != m_componentSearchList.end(); componentIterator++) {
+
+        auto component = componentIterator.value();
+
+        if (component->filename() != componentFilename) {
+            continue;
+        }
+
+        // a component that was deliberately unloaded is kept so that the replacement file is not loaded by a rescan
+
+        if (component->m_isLoaded ||
+            component->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred) ||
+            component->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::UnloadRequested)) {
+
+            return false;
+        }
+
+        m_componentSearchList.erase(componentIterator);
+        m_providersIndexed = false;
+
+        releaseComponent(component);
+
+        return true;
+    }
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::releaseComponent(
+        Nedrysoft::ComponentSystem::Component *component) -> void {
+
+    // the edges of other unloaded components that refer to the component are removed before the slot is reused
+
+    for (auto dependent : component->m_dependents) {
+        int dependencyIndex;
+
+        while (( dependencyIndex = dependent->m_dependencies.indexOf(component) ) >= 0) {
+            dependent->m_dependencies.removeAt(dependencyIndex);
+            dependent->m_dependencyVersions.removeAt(dependencyIndex);
+        }
+    }
+
+    component->removeDependencies();
+
+    // the once flag makes a component non-assignable, so the slot is reset by constructing an empty component
+
+    component->~Component();
+
+    new (component) Nedrysoft::ComponentSystem::Component();
+
+    m_componentArena->freeComponents.push_back(component);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::releaseComponents(
+        const QList<Nedrysoft::ComponentSystem::Component *> &components) -> void {
+
+    for (auto component : components) {
+        releaseComponent(component);
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::setWatchEnabled(bool enabled) -> void {
+    if (enabled == ( m_fileSystemWatcher != nullptr )) {
+        return;
+    }
+
+    if (!enabled) {
+        delete m_fileSystemWatcher;
+
+        m_fileSystemWatcher = nullptr;
+
+        m_rescanTimer->stop();
+
+        return;
+    }
+
+    m_fileSystemWatcher = new QFileSystemWatcher(this);
+
+    if (!m_componentFolders.isEmpty()) {
+        m_fileSystemWatcher->addPaths(m_componentFolders);
+    }
+
+    // files are usually copied into the folder over a period of time, so the rescan is delayed until the folder
+    // has stopped changing
+
+    connect(m_fileSystemWatcher, &QFileSystemWatcher::directoryChanged, m_rescanTimer, [this](const QString &) {
+        m_rescanTimer->start();
+    });
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::createComponent(
+        const QString &componentFilename,
+        const QJsonObject &metaDataObject,
+        bool applicationDebugBuild,
+        const QVersionNumber &applicationQtVersion) -> Nedrysoft::ComponentSystem::Component * {
+
+    if (metaDataObject.isEmpty()) {
+        return nullptr;
+    }
+
+    auto componentMetadata = metaDataObject.value("MetaData");
+    auto debugBuild = metaDataObject.value("debug");
+    auto qtVersion = metaDataObject.value("version");
+
+    if (debugBuild.isNull() || qtVersion.isNull() || componentMetadata.isNull()) {
+        return nullptr;
+    }
+
+    if (debugBuild != applicationDebugBuild) {
+        return nullptr;
+    }
+
+    auto componentName = componentMetadata.toObject().value("Name");
+
+    if (componentName.isNull()) {
+        return nullptr;
+    }
+
+    auto componentQtMajor = static_cast<int>(( qtVersion.toVariant().toUInt() & QtMajorBitMask )
+            >> QtMajorBitShift);
+    auto componentQtMinor = static_cast<int>(( qtVersion.toVariant().toUInt() & QtMinorBitMask )
+            >> QtMinorBitShift);
+    auto componentQtPatch = static_cast<int>(( qtVersion.toVariant().toUInt() & QtPatchBitMask )
+            >> QtPatchBitShift);
+
+    auto componentQtVersion = QVersionNumber(componentQtMajor, componentQtMinor, componentQtPatch);
+
+    // components are constructed in place in the arena, which is freed in bulk when the loader is destroyed, a
+    // released slot is reused before the arena is grown
+
+    Nedrysoft::ComponentSystem::Component *component;
+
+    if (!m_componentArena->freeComponents.empty()) {
+        component = m_componentArena->freeComponents.back();
+
+        m_componentArena->freeComponents.pop_back();
+
+        component->~Component();
+
+        new (component) Nedrysoft::ComponentSystem::Component(
+                componentName.toString(),
+                componentFilename,
+                metaDataObject);
+    } else {
+        m_componentArena->components.emplace_back(componentName.toString(), componentFilename, metaDataObject);
+
+        component = &m_componentArena->components.back();
+    }
+
+    internStrings(component);
+
+    if (componentQtVersion.majorVersion() != applicationQtVersion.majorVersion()) {
+        component->m_loadFlags.setFlag(IncompatibleQtVersion);
+    }
+
+    return component;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::internString(const QString &string) -> QString {
+    auto internIterator = m_internedStrings.constFind(string);
+
+    if (internIterator != m_internedStrings.constEnd()) {
+        return *internIterator;
+    }
+
+    m_internedStrings.insert(string);
+
+    return string;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::internStrings(Nedrysoft::ComponentSystem::Component *component) -> void {
+    // values such as the category and vendor are repeated across many components, interning them means that the
+    // components of this loader refer to the same implicitly shared string data
+
+    component->m_category = internString(component->m_category);
+    component->m_vendor = internString(component->m_vendor);
+    component->m_copyright = internString(component->m_copyright);
+
+    for (auto &interfaceName : component->m_providedInterfaces) {
+        interfaceName = internString(interfaceName);
+    }
+
+    for (auto &interfaceName : component->m_consumedInterfaces) {
+        interfaceName = internString(interfaceName);
+    }
+
+    for (auto &dependency : component->m_dependencyRequirements) {
+        dependency.name = internString(dependency.name);
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::parallelFor(int count, const std::function<void(int)> &function) -> void {
+    if (count <= 1) {
+        if (count == 1) {
+            function(0);
+        }
+
+        return;
+    }
+
+    QAtomicInt nextIndex(0);
+
+    auto taskCount = qMin(count, m_threadPool->maxThreadCount());
+
+    for (auto taskIndex = 0; taskIndex < taskCount; taskIndex++) {
+        m_threadPool->start(new ParallelTask([&nextIndex, &function, count]() {
+            int index;
+
+            while (( index = nextIndex.fetchAndAddRelaxed(1) ) < count) {
+                function(index);
+            }
+        }));
+    }
+
+    m_threadPool->waitForDone();
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadComponents(
+        std::function<bool(Nedrysoft::ComponentSystem::Component *)> loadFunction) -> void {
+
+    clearUnloadRequests();
+
+    loadDiscoveredComponents(loadFunction);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::clearUnloadRequests() -> void {
+    for (auto component : m_componentSearchList) {
+        component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::UnloadRequested, false);
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadDiscoveredComponents(
+        const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> void {
+
+    m_loadFunction = loadFunction;
+    m_componentsLoaded = true;
+
+    auto resolvedLoadList = resolveLoadList();
+
+    // components that are activated on demand are deferred, unless a component loaded now depends on them
+
+    deferLazyComponents(resolvedLoadList, loadFunction);
+
+    // load the components that we have satisfied dependencies for
+
+    auto firstLoadIndex = m_loadOrder.count();
+
+    if (m_parallelLoading) {
+        loadComponentWaves(resolvedLoadList, loadFunction);
+    } else {
+        for (auto component : resolvedLoadList) {
+            if (!canLoadComponent(component, loadFunction)) {
+                continue;
+            }
+
+            auto pluginLoader = createPluginLoader(component);
+
+            instantiateComponent(component, pluginLoader, loadLibrary(component, pluginLoader));
+        }
+    }
+
+    initialiseComponents(firstLoadIndex);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::resolveLoadList() -> QList<Nedrysoft::ComponentSystem::Component *> {
+    QList<Nedrysoft::ComponentSystem::Component *> componentLoadList;
+
+    // find and add dependencies from the search
+
+    auto componentIterator = QMapIterator<QString, Nedrysoft::ComponentSystem::Component *>(m_componentSearchList);
+
+    while (componentIterator.hasNext()) {
+        componentIterator.next();
+
+        auto component = componentIterator.value();
+
+        if (component->m_loadFlags) {
+            continue;
+        }
+
+        // a component that was unloaded by unloadComponent still has the edges from when it was first loaded
+
+        component->removeDependencies();
+
+        component->m_dependencies.reserve(component->m_dependencyRequirements.count());
+        component->m_dependencyVersions.reserve(component->m_dependencyRequirements.count());
+
+        for (const auto &dependency : component->m_dependencyRequirements) {
+            auto dependencyIterator = m_componentSearchList.constFind(dependency.name);
+
+            if (dependencyIterator != m_componentSearchList.constEnd()) {
+                component->addDependency(dependencyIterator.value(), dependency.version);
+            } else {
+                component->m_missingDependencies.append(dependency.name);
+                component->m_loadFlags |= MissingDependency;
+            }
+        }
+
+        if (!component->m_loadFlags) {
+            componentLoadList.append(component);
+        }
+    }
+
+    // resolve the dependencies to create a load order, the order from a manifest is used if it covers every
+    // component that is to be loaded
+
+    QList<Nedrysoft::ComponentSystem::Component *> resolvedLoadList;
+    QSet<Nedrysoft::ComponentSystem::Component *> manifestComponents;
+
+    for (auto component : m_manifestLoadOrder) {
+        manifestComponents.insert(component);
+    }
+
+    auto manifestCoversLoadList = !manifestComponents.isEmpty() && std::all_of(
+            componentLoadList.begin(),
+            componentLoadList.end(),
+            [&manifestComponents](Nedrysoft::ComponentSystem::Component *component) {
+                return manifestComponents.contains(component);
+            });
+
+    if (manifestCoversLoadList) {
+        resolvedLoadList = m_manifestLoadOrder;
+    } else {
+        resolvedLoadList = resolve(componentLoadList);
+    }
+
+    // components loaded by an earlier call are already initialised and are left untouched
+
+    auto isLoaded = [](Nedrysoft::ComponentSystem::Component *component) {
+        return component->m_isLoaded;
+    };
+
+    resolvedLoadList.erase(
+            std::remove_if(resolvedLoadList.begin(), resolvedLoadList.end(), isLoaded),
+            resolvedLoadList.end());
+
+    return resolvedLoadList;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadComponentsAsync(
+        const QStringList &componentFolders,
+        std::function<bool(Nedrysoft::ComponentSystem::Component *)> loadFunction) -> void {
+
+    if (m_asyncLoading) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_WARN("an asynchronous load is already in progress.");
+
+        return;
+    }
+
+    m_asyncLoading = true;
+    m_componentsLoaded = true;
+    m_loadFunction = loadFunction;
+
+    clearUnloadRequests();
+
+    addComponentFolders(componentFolders);
+
+    auto asyncLoad = std::make_shared<Nedrysoft::ComponentSystem::AsyncLoad>();
+
+    asyncLoad->componentFolders = componentFolders;
+    asyncLoad->firstLoadIndex = m_loadOrder.count();
+
+    // the folders are searched and the metadata read on the worker, the results are private to the load until
+    // they are handed back to the loader thread
+
+    m_asyncThreadPool->start(new ParallelTask([this, asyncLoad, loadFunction]() {
+        if (!asyncLoad->componentFolders.isEmpty()) {
+            asyncLoad->candidateFiles = findCandidateFiles(asyncLoad->componentFolders);
+            asyncLoad->candidateMetadata = readCandidateMetadata(asyncLoad->candidateFiles);
+
+            pruneMetadataCache(asyncLoad->componentFolders);
+        }
+
+        if (m_asyncCancelled.loadAcquire()) {
+            return;
+        }
+
+        QMetaObject::invokeMethod(this, [this, asyncLoad, loadFunction]() {
+            resolveAsyncLoad(asyncLoad, loadFunction);
+        }, Qt::QueuedConnection);
+    }));
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::resolveAsyncLoad(
+        const std::shared_ptr<Nedrysoft::ComponentSystem::AsyncLoad> &asyncLoad,
+        const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> void {
+
+    addCandidateFiles(asyncLoad->candidateFiles, asyncLoad->candidateMetadata);
+
+    asyncLoad->resolvedLoadList = resolveLoadList();
+
+    const auto &resolvedLoadList = asyncLoad->resolvedLoadList;
+
+    // the application load function is called once for each candidate component
+
+    QSet<Nedrysoft::ComponentSystem::Component *> disabledComponents;
+
+    if (loadFunction) {
+        for (auto component : resolvedLoadList) {
+            if (!component->m_loadFlags && !loadFunction(component)) {
+                disabledComponents.insert(component);
+            }
+        }
+    }
+
+    asyncLoad->loadFunction = [disabledComponents](Nedrysoft::ComponentSystem::Component *component) {
+        return !disabledComponents.contains(component);
+    };
+
+    deferLazyComponents(resolvedLoadList, asyncLoad->loadFunction);
+
+    // decide which libraries to load before any component is instantiated, a library is not loaded if the
+    // component (or one of its dependencies) will not be loaded
+
+    asyncLoad->pluginLoaders.fill(nullptr, resolvedLoadList.count());
+    asyncLoad->loadRequired.fill(false, resolvedLoadList.count());
+    asyncLoad->libraryLoaded.fill(false, resolvedLoadList.count());
+
+    QSet<Nedrysoft::ComponentSystem::Component *> pendingComponents;
+
+    for (auto loadIndex = 0; loadIndex < resolvedLoadList.count(); loadIndex++) {
+        auto component = resolvedLoadList.at(loadIndex);
+
+        if (component->m_loadFlags || disabledComponents.contains(component)) {
+            continue;
+        }
+
+        auto dependenciesAvailable = std::all_of(
+                component->m_dependencies.begin(),
+                component->m_dependencies.end(),
+                [&pendingComponents](Nedrysoft::ComponentSystem::Component *dependency) {
+                    return dependency->m_isLoaded || pendingComponents.contains(dependency);
+                });
+
+        if (!dependenciesAvailable) {
+            continue;
+        }
+
+        pendingComponents.insert(component);
+
+        asyncLoad->loadRequired[loadIndex] = true;
+        asyncLoad->pluginLoaders[loadIndex] = createPluginLoader(component);
+    }
+
+    if (m_parallelLoading) {
+        asyncLoad->waves = loadWaves(resolvedLoadList);
+    }
+
+    m_asyncThreadPool->start(new ParallelTask([this, asyncLoad]() {
+        loadAsyncLibraries(asyncLoad);
+    }));
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadAsyncLibraries(
+        const std::shared_ptr<Nedrysoft::ComponentSystem::AsyncLoad> &asyncLoad) -> void {
+
+    auto loadComponentLibrary = [this, &asyncLoad](int loadIndex) {
+        if (( asyncLoad->loadRequired.at(loadIndex) ) && ( !m_asyncCancelled.loadAcquire() )) {
+            asyncLoad->libraryLoaded[loadIndex] = loadLibrary(
+                    asyncLoad->resolvedLoadList.at(loadIndex),
+                    asyncLoad->pluginLoaders.at(loadIndex));
+        }
+    };
+
+    // instances are created on the loader thread in dependency order, as the queued calls are delivered in
+    // the order that they were posted
+
+    auto postInstantiation = [this, &asyncLoad](int loadIndex) {
+        QMetaObject::invokeMethod(this, [this, asyncLoad, loadIndex]() {
+            instantiateAsyncComponent(asyncLoad, loadIndex);
+        }, Qt::QueuedConnection);
+    };
+
+    if (m_parallelLoading) {
+        // the libraries in a wave have no dependencies on each other, so they can be loaded concurrently
+
+        for (const auto &waveIndices : asyncLoad->waves) {
+            parallelFor(waveIndices.count(), [&loadComponentLibrary, &waveIndices](int waveIndex) {
+                loadComponentLibrary(waveIndices.at(waveIndex));
+            });
+
+            if (m_asyncCancelled.loadAcquire()) {
+                return;
+            }
+
+            for (auto loadIndex : waveIndices) {
+                postInstantiation(loadIndex);
+            }
+        }
+    } else {
+        for (auto loadIndex = 0; loadIndex < asyncLoad->resolvedLoadList.count(); loadIndex++) {
+            loadComponentLibrary(loadIndex);
+
+            if (m_asyncCancelled.loadAcquire()) {
+                return;
+            }
+
+            postInstantiation(loadIndex);
+        }
+    }
+
+    QMetaObject::invokeMethod(this, [this, asyncLoad]() {
+        finishAsyncLoad(asyncLoad);
+    }, Qt::QueuedConnection);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::instantiateAsyncComponent(
+        const std::shared_ptr<Nedrysoft::ComponentSystem::AsyncLoad> &asyncLoad,
+        int loadIndex) -> void {
+
+    auto component = asyncLoad->resolvedLoadList.at(loadIndex);
+    auto pluginLoader = asyncLoad->pluginLoaders.at(loadIndex);
+
+    // the plugin loader is now owned by the component (or deleted), so it is no longer owned by the load
+
+    asyncLoad->pluginLoaders[loadIndex] = nullptr;
+
+    if (!canLoadComponent(component, asyncLoad->loadFunction)) {
+        if (pluginLoader) {
+#if !defined(Q_OS_MACOS)
+            pluginLoader->unload();
+#endif
+            delete pluginLoader;
+        }
+    } else if (!asyncLoad->loadRequired.at(loadIndex)) {
+        component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::MissingDependency);
+    } else if (instantiateComponent(component, pluginLoader, asyncLoad->libraryLoaded.at(loadIndex))) {
+        Q_EMIT componentLoaded(component);
+    }
+
+    asyncLoad->progressCount++;
+
+    Q_EMIT progress(asyncLoad->progressCount, asyncLoad->resolvedLoadList.count());
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::finishAsyncLoad(
+        const std::shared_ptr<Nedrysoft::ComponentSystem::AsyncLoad> &asyncLoad) -> void {
+
+    // waves are instantiated out of resolved order, the order is restored so that the lifecycle events are
+    // called in the same order as a serial load
+
+    restoreLoadOrder(asyncLoad->firstLoadIndex, asyncLoad->resolvedLoadList);
+
+    initialiseComponents(asyncLoad->firstLoadIndex);
+
+    m_asyncLoading = false;
+
+    // components that were requested while the load was in progress are activated now
+
+    auto pendingActivations = m_pendingActivations;
+
+    m_pendingActivations.clear();
+
+    for (auto component : pendingActivations) {
+        activateComponent(component);
+    }
+
+    Q_EMIT loadFinished();
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::initialiseComponents(int firstLoadIndex) -> void {
+    // a component may activate a lazy component while it initialises, the activated component is initialised by
+    // the activation so only the components that were loaded when this function was called are visited here
+
+    auto lastLoadIndex = m_loadOrder.count();
+
+    updateImageSizes(firstLoadIndex, lastLoadIndex);
+
+    auto concurrentInitialisation = std::any_of(
+            m_loadOrder.begin() + firstLoadIndex,
+            m_loadOrder.begin() + lastLoadIndex,
+            [](const QPair<QPluginLoader *, Component *> &loadedComponent) {
+                return loadedComponent.second->hasConcurrentInitialisation();
+            });
+
+    // a lazy component activated by a concurrent initialiseEvent is initialised serially, the thread pool may be
+    // fully occupied by the components waiting for the activation
+
+    if (( concurrentInitialisation ) && ( !m_concurrentInitialisation )) {
+        m_concurrentInitialisation = true;
+
+        initialiseComponentLevels(firstLoadIndex, lastLoadIndex);
+
+        m_concurrentInitialisation = false;
+    } else {
+        // call initialiseEvent for each component (in load order)
+
+        for (auto loadIndex = firstLoadIndex; loadIndex < lastLoadIndex; loadIndex++) {
+            initialiseComponent(m_loadOrder.at(loadIndex).first, m_loadOrder.at(loadIndex).second);
+        }
+    }
+
+    // call initialisationFinishedEvent for each component (in reverse load order)
+
+    for (auto loadIndex = lastLoadIndex - 1; loadIndex >= firstLoadIndex; loadIndex--) {
+        auto componentInterface = componentInstance(m_loadOrder.at(loadIndex).first, m_loadOrder.at(loadIndex).second);
+
+        auto startTime = m_timer.nsecsElapsed();
+
+        auto previousOwner = IComponentManager::setCurrentOwner(m_loadOrder.at(loadIndex).second);
+
+        componentInterface->initialisationFinishedEvent();
+
+        IComponentManager::setCurrentOwner(previousOwner);
+
+        recordTiming(m_loadOrder.at(loadIndex).second->name(), LoadPhase::InitialisationFinished, startTime);
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::updateImageSizes(int firstLoadIndex, int lastLoadIndex) -> void {
+#if defined(Q_OS_LINUX)
+    if (firstLoadIndex >= lastLoadIndex) {
+        return;
+    }
+
+    auto imageSizes = Nedrysoft::ComponentSystem::Component::mappedImageSizes();
+
+    for (auto loadIndex = firstLoadIndex; loadIndex < lastLoadIndex; loadIndex++) {
+        auto component = m_loadOrder.at(loadIndex).second;
+
+        if (!component->isStatic()) {
+            component->m_imageSize = imageSizes.value(QFileInfo(component->filename()).canonicalFilePath());
+        }
+    }
+#else
+    Q_UNUSED(firstLoadIndex)
+    Q_UNUSED(lastLoadIndex)
+#endif
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::initialiseComponent(
+        QPluginLoader *pluginLoader,
+        Nedrysoft::ComponentSystem::Component *component) -> void {
+
+    auto componentInterface = componentInstance(pluginLoader, component);
+
+    auto startTime = m_timer.nsecsElapsed();
+
+    // objects registered by the component while it initialises are attributed to it
+
+    auto previousOwner = IComponentManager::setCurrentOwner(component);
+
+    componentInterface->initialiseEvent();
+
+    IComponentManager::setCurrentOwner(previousOwner);
+
+    recordTiming(component->name(), LoadPhase::Initialise, startTime);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::initialiseComponentLevels(
+        int firstLoadIndex,
+        int lastLoadIndex) -> void {
+
+    QMutex pendingMutex;
+    QWaitCondition pendingChanged;
+    QSet<Nedrysoft::ComponentSystem::Component *> batchComponents;
+
+    auto pendingCount = 0;
+    auto activationRequested = false;
+
+    auto componentManager = IComponentManager::getInstance();
+
+    // a concurrent initialiseEvent that activates a lazy component waits until the loader thread has activated it,
+    // so the request wakes the loader thread, which runs the activation while it waits for the batch
+
+    auto requestConnection = connect(
+            componentManager,
+            &IComponentManager::activationRequested,
+            this,
+            [&pendingMutex, &pendingChanged, &activationRequested]() {
+
+        QMutexLocker locker(&pendingMutex);
+
+        activationRequested = true;
+
+        pendingChanged.wakeAll();
+    }, Qt::DirectConnection);
+
+    auto waitForBatch = [componentManager, &pendingMutex, &pendingChanged, &pendingCount, &activationRequested]() {
+        QMutexLocker locker(&pendingMutex);
+
+        while (pendingCount) {
+            if (activationRequested) {
+                activationRequested = false;
+
+                locker.unlock();
+
+                componentManager->runRequestedActivations();
+
+                locker.relock();
+
+                continue;
+            }
+
+            pendingChanged.wait(&pendingMutex);
+        }
+    };
+
+    // the components are visited in load order.  Components that opted in are started on the thread pool as a
+    // batch, which is finished before a component that depends on one of them is started, and before any component
+    // that did not opt in is initialised on the calling thread, so those see the same order as a serial load
+
+    for (auto loadIndex = firstLoadIndex; loadIndex < lastLoadIndex; loadIndex++) {
+        auto pluginLoader = m_loadOrder.at(loadIndex).first;
+        auto component = m_loadOrder.at(loadIndex).second;
+
+        auto dependsOnBatch = std::any_of(
+                component->m_dependencies.begin(),
+                component->m_dependencies.end(),
+                [&batchComponents](Nedrysoft::ComponentSystem::Component *dependency) {
+                    return batchComponents.contains(dependency);
+                });
+
+        if (( dependsOnBatch ) || ( !component->hasConcurrentInitialisation() )) {
+            waitForBatch();
+
+            batchComponents.clear();
+        }
+
+        if (!component->hasConcurrentInitialisation()) {
+            initialiseComponent(pluginLoader, component);
+
+            continue;
+        }
+
+        batchComponents.insert(component);
+
+        pendingMutex.lock();
+        pendingCount++;
+        pendingMutex.unlock();
+
+        m_threadPool->start(new ParallelTask(
+                [this, pluginLoader, component, &pendingMutex, &pendingChanged, &pendingCount]() {
+
+            initialiseComponent(pluginLoader, component);
+
+            QMutexLocker locker(&pendingMutex);
+
+            pendingCount--;
+
+            pendingChanged.wakeAll();
+        }));
+    }
+
+    waitForBatch();
+
+    disconnect(requestConnection);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::deferLazyComponents(
+        const QList<Nedrysoft::ComponentSystem::Component *> &resolvedLoadList,
+        const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> void {
+
+    QSet<Nedrysoft::ComponentSystem::Component *> requiredComponents;
+
+    // walk the list in reverse dependency order so that a component is always visited before its dependencies
+
+    for (auto componentIterator = resolvedLoadList.rbegin();
+         componentIterator != resolvedLoadList.rend(); componentIterator++) {
+
+        auto component = *componentIterator;
+
+        if (!component->isLazy() || requiredComponents.contains(component)) {
+            for (auto dependency : component->m_dependencies) {
+                requiredComponents.insert(dependency);
+            }
+
+            // a component deferred by an earlier call is loaded now that a component depends on it
+
+            component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred, false);
+
+            continue;
+        }
+
+        if (component->m_loadFlags) {
+            continue;
+        }
+
+        if (loadFunction) {
+            if (!loadFunction(component)) {
+                component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Disabled);
+
+                continue;
+            }
+        }
+
+        component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred);
+
+        addActivators(component);
+
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("component {} was deferred.", component->name().toStdString());
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::addActivators(Nedrysoft::ComponentSystem::Component *component) -> void {
+    for (const auto &interfaceName : component->providedInterfaces()) {
+        IComponentManager::getInstance()->addActivator(this, interfaceName, [this, component]() {
+            activateComponent(component);
+        });
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::activateComponent(
+        Nedrysoft::ComponentSystem::Component *component) -> void {
+
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, component]() {
+            activateComponent(component);
+        }, Qt::BlockingQueuedConnection);
+
+        return;
+    }
+
+    if (!component->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred)) {
+        return;
+    }
+
+    // the lifecycle events of an asynchronous load are delivered together, so activation waits until it finishes
+
+    if (m_asyncLoading) {
+        if (!m_pendingActivations.contains(component)) {
+            m_pendingActivations.append(component);
+        }
+
+        return;
+    }
+
+    // deferred dependencies are activated (in dependency order) before the component itself, preceded by the
+    // deferred providers of the interfaces that the component consumes
+
+    QList<Nedrysoft::ComponentSystem::Component *> activationList;
+    QSet<Nedrysoft::ComponentSystem::Component *> visitedComponents;
+
+    addActivation(component, activationList, visitedComponents);
+
+    auto firstLoadIndex = m_loadOrder.count();
+
+    for (auto activationComponent : resolve(activationList)) {
+        if (!activationComponent->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred)) {
+            continue;
+        }
+
+        activationComponent->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred, false);
+
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("activating component {}.", activationComponent->name().toStdString());
+
+        if (!canLoadComponent(activationComponent, nullptr)) {
+            continue;
+        }
+
+        auto pluginLoader = createPluginLoader(activationComponent);
+
+        instantiateComponent(activationComponent, pluginLoader, loadLibrary(activationComponent, pluginLoader));
+    }
+
+    initialiseComponents(firstLoadIndex);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::addActivation(
+        Nedrysoft::ComponentSystem::Component *component,
+        QList<Nedrysoft::ComponentSystem::Component *> &activationList,
+        QSet<Nedrysoft::ComponentSystem::Component *> &visitedComponents) -> void {
+
+    if (visitedComponents.contains(component)) {
+        return;
+    }
+
+    visitedComponents.insert(component);
+
+    for (const auto &interfaceName : component->consumedInterfaces()) {
+        for (auto provider : providers(interfaceName)) {
+            if (provider->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred)) {
+                addActivation(provider, activationList, visitedComponents);
+            }
+        }
+    }
+
+    activationList.append(component);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::setParallelLoading(bool enabled) -> void {
+    m_parallelLoading = enabled;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::setFastExit(bool enabled) -> void {
+    m_fastExit = enabled;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::canLoadComponent(
+        Nedrysoft::ComponentSystem::Component *component,
+        const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> bool {
+
+    if (component->m_loadFlags.testFlag(Nedrysoft::ComponentSystem::ComponentLoader::Deferred)) {
+        return false;
+    }
+
+    if (component->m_loadFlags) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                "component {} was not loaded. ({})",
+                component->name().toStdString(),
+                loadFlagString(component->m_loadFlags).toStdString());
+
+        return false;
+    }
+
+    // check if dependencies are loaded, if not then this component cannot be loaded
+
+    component->validateDependencies();
+
+    if (component->m_loadFlags) {
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                "component {} was not loaded. ({})",
+                component->name().toStdString(),
+                loadFlagString(component->m_loadFlags).toStdString());
+
+        return false;
+    }
+
+    if (loadFunction) {
+        if (!loadFunction(component)) {
+            component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Disabled);
+
+            NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                    "component {} was not loaded. ({})",
+                    component->name().toStdString(),
+                    loadFlagString(component->m_loadFlags).toStdString());
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::instantiateComponent(
+        Nedrysoft::ComponentSystem::Component *component,
+        QPluginLoader *pluginLoader,
+        bool libraryLoaded) -> bool {
+
+    if (!libraryLoaded) {
+        component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::UnableToLoad);
+
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                "component {} was not loaded. ({}) [{}]",
+                component->name().toStdString(),
+                loadFlagString(component->m_loadFlags).toStdString(),
+                pluginLoader ? pluginLoader->errorString().toStdString() : std::string());
+
+        delete pluginLoader;
+
+        return false;
+    }
+
+    auto startTime = m_timer.nsecsElapsed();
+
+    if (component->m_staticInstanceFunction) {
+        component->m_staticInstance = component->m_staticInstanceFunction();
+    }
+
+    auto componentInterface = componentInstance(pluginLoader, component);
+
+    recordTiming(component->name(), LoadPhase::InstanceCreation, startTime);
+
+    if (!componentInterface) {
+        component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::MissingInterface);
+
+        delete pluginLoader;
+
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(
+                "component {} was not loaded. ({})",
+                component->name().toStdString(),
+                loadFlagString(component->m_loadFlags).toStdString());
+
+        return false;
+    }
+
+    component->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Loaded);
+
+    m_loadOrder.append(QPair<QPluginLoader *, Component *>(pluginLoader, component));
+
+    component->m_isLoaded = true;
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadWaves(
+        const QList<Nedrysoft::ComponentSystem::Component *> &resolvedLoadList) -> QList<QList<int> > {
+
+    QHash<Nedrysoft::ComponentSystem::Component *, int> componentWave;
+    QList<QList<int> > waves;
+
+    // the resolved list is in dependency order, so the wave of each dependency is known before its dependents
+
+    for (auto componentIndex = 0; componentIndex < resolvedLoadList.count(); componentIndex++) {
+        auto component = resolvedLoadList.at(componentIndex);
+        auto wave = 0;
+
+        for (auto dependency : component->m_dependencies) {
+            if (componentWave.contains(dependency)) {
+                wave = qMax(wave, componentWave.value(dependency) + 1);
+            }
+        }
+
+        componentWave[component] = wave;
+
+        while (waves.count() <= wave) {
+            waves.append(QList<int>());
+        }
+
+        waves[wave].append(componentIndex);
+    }
+
+    return waves;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::restoreLoadOrder(
+        int firstLoadIndex,
+        const QList<Nedrysoft::ComponentSystem::Component *> &resolvedLoadList) -> void {
+
+    QHash<Nedrysoft::ComponentSystem::Component *, int> resolvedIndex;
+
+    for (auto componentIndex = 0; componentIndex < resolvedLoadList.count(); componentIndex++) {
+        resolvedIndex[resolvedLoadList.at(componentIndex)] = componentIndex;
+    }
+
+    std::stable_sort(m_loadOrder.begin() + firstLoadIndex, m_loadOrder.end(),
+            [&resolvedIndex](const QPair<QPluginLoader *, Component *> &left,
+                             const QPair<QPluginLoader *, Component *> &right) {
+
+        return resolvedIndex.value(left.second) < resolvedIndex.value(right.second);
+    });
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadComponentWaves(
+        const QList<Nedrysoft::ComponentSystem::Component *> &resolvedLoadList,
+        const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> void {
+
+    auto firstLoadIndex = m_loadOrder.count();
+
+    for (const auto &waveIndices : loadWaves(resolvedLoadList)) {
+        QList<Nedrysoft::ComponentSystem::Component *> loadList;
+        QList<QPluginLoader *> pluginLoaders;
+
+        for (auto componentIndex : waveIndices) {
+            auto component = resolvedLoadList.at(componentIndex);
+
+            if (!canLoadComponent(component, loadFunction)) {
+                continue;
+            }
+
+            loadList.append(component);
+            pluginLoaders.append(createPluginLoader(component));
+        }
+
+        // the libraries in a wave have no dependencies on each other, so they can be loaded concurrently
+
+        QVector<bool> libraryLoaded(loadList.count());
+
+        parallelFor(loadList.count(), [this, &loadList, &pluginLoaders, &libraryLoaded](int loadIndex) {
+            libraryLoaded[loadIndex] = loadLibrary(loadList.at(loadIndex), pluginLoaders.at(loadIndex));
+        });
+
+        // instances are created on the calling thread in resolved order
+
+        for (auto loadIndex = 0; loadIndex < loadList.count(); loadIndex++) {
+            instantiateComponent(loadList.at(loadIndex), pluginLoaders.at(loadIndex), libraryLoaded.at(loadIndex));
+        }
+    }
+
+    // restore the resolved order so that the lifecycle events are called in the same order as a serial load
+
+    restoreLoadOrder(firstLoadIndex, resolvedLoadList);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::components() -> QList<Nedrysoft::ComponentSystem::Component *> {
+    return m_componentSearchList.values();
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::providers(
+        const QString &interfaceName) -> QList<Nedrysoft::ComponentSystem::Component *> {
+
+    // the index is rebuilt the first time that it is needed after the set of discovered components changes
+
+    if (!m_providersIndexed) {
+        m_interfaceProviders.clear();
+
+        for (auto component : m_componentSearchList) {
+            for (const auto &providedInterface : component->providedInterfaces()) {
+                m_interfaceProviders[providedInterface].append(component);
+            }
+        }
+
+        m_providersIndexed = true;
+    }
+
+    return m_interfaceProviders.value(interfaceName);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::resolve(
+        const QList<Nedrysoft::ComponentSystem::Component *> &components) -> QList<Nedrysoft::ComponentSystem::Component *> {
+
+    QList<Nedrysoft::ComponentSystem::Component *> resolvedList;
+    QHash<Nedrysoft::ComponentSystem::Component *, ResolveState> resolveState;
+    QList<Nedrysoft::ComponentSystem::Component *> resolvePath;
+
+    resolvedList.reserve(components.count());
+    resolveState.reserve(components.count());
+
+    for (auto component : components) {
+        resolve(component, resolvedList, resolveState, resolvePath);
+    }
+
+    return resolvedList;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::resolve(
+        Nedrysoft::ComponentSystem::Component *component,
+        QList<Nedrysoft::ComponentSystem::Component *> &resolvedList,
+        QHash<Nedrysoft::ComponentSystem::Component *, ResolveState> &resolveState,
+        QList<Nedrysoft::ComponentSystem::Component *> &resolvePath) -> void {
+
+    if (resolveState.value(component, ResolveState::Unvisited) != ResolveState::Unvisited) {
+        return;
+    }
+
+    resolveState[component] = ResolveState::Visiting;
+    resolvePath.append(component);
+
+    for (auto dependency : component->m_dependencies) {
+        auto dependencyState = resolveState.value(dependency, ResolveState::Unvisited);
+
+        if (dependencyState == ResolveState::Resolved) {
+            continue;
+        }
+
+        if (dependencyState == ResolveState::Visiting) {
+            // the dependency is already on the current path, so we have found a cycle
+
+            QStringList cycleNames;
+
+            for (auto cycleIndex = resolvePath.indexOf(dependency); cycleIndex < resolvePath.count(); cycleIndex++) {
+                auto cycleComponent = resolvePath.at(cycleIndex);
+
+                cycleComponent->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::CircularDependency);
+
+                cycleNames.append(cycleComponent->name());
+            }
+
+            cycleNames.append(dependency->name());
+
+            NEDRYSOFT_COMPONENTSYSTEM_LOG_WARN("circular dependency detected: {}", cycleNames.join(" -> ").toStdString());
+
+            continue;
+        }
+
+        resolve(dependency, resolvedList, resolveState, resolvePath);
+    }
+
+    resolvePath.removeLast();
+    resolveState[component] = ResolveState::Resolved;
+
+    resolvedList.append(component);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::unloadComponents() -> void {
+    IComponentManager::getInstance()->removeActivators(this);
+
+    for (auto loadedComponentIterator = m_loadOrder.rbegin();
+        loadedComponentIterator < m_loadOrder.rend(); loadedComponentIterator++) {
+
+        auto pluginLoader = loadedComponentIterator->first;
+        auto component = loadedComponentIterator->second;
+
+        // when exiting quickly, only the components that ask for it are finalised and nothing is unloaded
+
+        if (m_fastExit && !component->finalisesOnExit()) {
+            continue;
+        }
+
+        auto componentInterface = componentInstance(pluginLoader, component);
+
+        if (!componentInterface) {
+            continue;
+        }
+
+        auto startTime = m_timer.nsecsElapsed();
+
+        componentInterface->finaliseEvent();
+
+        recordTiming(component->name(), LoadPhase::Finalise, startTime);
+
+        if (m_fastExit) {
+            continue;
+        }
+
+        if (pluginLoader) {
+#if !defined(Q_OS_MACOS)
+            /**
+             * NOTE: calling unload on macOS causes the application to crash, so we leak the memory as it's of no
+             * consequence as all memory will be freed when we exit.  For Windows and Linux we include the unload
+             * for completeness and to stop memory leak analysers reporting a leak.
+             */
+            pluginLoader->unload();
+#endif
+            delete pluginLoader;
+        } else {
+            releaseStaticInstance(component);
+        }
+    }
+
+    m_loadOrder.clear();
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::unloadComponent(
+        Nedrysoft::ComponentSystem::Component *component) -> void {
+
+    if (!component || !component->m_isLoaded) {
+        return;
+    }
+
+    // find the subtree of loaded components that depend (directly or indirectly) on the component
+
+    QSet<Nedrysoft::ComponentSystem::Component *> affectedComponents;
+    QList<Nedrysoft::ComponentSystem::Component *> pendingComponents;
+
+    pendingComponents.append(component);
+
+    while (!pendingComponents.isEmpty()) {
+        auto affectedComponent = pendingComponents.takeLast();
+
+        if (!affectedComponent->m_isLoaded || affectedComponents.contains(affectedComponent)) {
+            continue;
+        }
+
+        affectedComponents.insert(affectedComponent);
+
+        pendingComponents.append(affectedComponent->m_dependents);
+    }
+
+    // the load order is a topological order, so walking it in reverse finalises dependents before dependencies
+
+    QList<QPair<QPluginLoader *, Nedrysoft::ComponentSystem::Component *> > unloadList;
+
+    for (auto loadIndex = m_loadOrder.count() - 1; loadIndex >= 0; loadIndex--) {
+        if (!affectedComponents.contains(m_loadOrder.at(loadIndex).second)) {
+            continue;
+        }
+
+        auto loadedComponent = m_loadOrder.takeAt(loadIndex);
+
+        auto componentInterface = componentInstance(loadedComponent.first, loadedComponent.second);
+
+        if (componentInterface) {
+            auto startTime = m_timer.nsecsElapsed();
+
+            componentInterface->finaliseEvent();
+
+            recordTiming(loadedComponent.second->name(), LoadPhase::Finalise, startTime);
+        }
+
+        unloadList.append(loadedComponent);
+    }
+
+    // the libraries are only released once every affected component has been finalised
+
+    for (const auto &unloadedComponent : unloadList) {
+        auto pluginLoader = unloadedComponent.first;
+
+        if (pluginLoader) {
+#if !defined(Q_OS_MACOS)
+            // see unloadComponents, unloading a library on macOS causes the application to crash
+
+            pluginLoader->unload();
+#endif
+            delete pluginLoader;
+        } else {
+            releaseStaticInstance(unloadedComponent.second);
+        }
+
+        // the component stays unloaded (a rescan will not load it again) until loadComponents is called
+
+        unloadedComponent.second->m_isLoaded = false;
+        unloadedComponent.second->m_imageSize = 0;
+        unloadedComponent.second->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::Loaded, false);
+        unloadedComponent.second->m_loadFlags.setFlag(Nedrysoft::ComponentSystem::ComponentLoader::UnloadRequested);
+
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("component {} was unloaded.", unloadedComponent.second->name().toStdString());
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::addStaticComponents() -> void {
+    auto applicationQtVersion = currentQtVersion();
+
+    for (const auto &staticPlugin : QPluginLoader::staticPlugins()) {
+        auto metaDataObject = staticPlugin.metaData();
+
+        // other static plugins (i.e qt platform plugins) share the list, so only components are considered
+
+        if (metaDataObject.value("IID").toString() != QLatin1String(NedrysoftComponentInterfaceIID)) {
+            continue;
+        }
+
+        auto componentFilename = QString("static:%1").arg(metaDataObject.value("className").toString());
+
+        if (m_staticComponentFilenames.contains(componentFilename)) {
+            continue;
+        }
+
+        m_staticComponentFilenames.insert(componentFilename);
+
+        NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("Found Component {}", componentFilename.toStdString());
+
+        // a static component is part of the application binary, so its build type always matches
+
+        auto component = createComponent(
+                componentFilename,
+                metaDataObject,
+                metaDataObject.value("debug").toBool(),
+                applicationQtVersion );
+
+        if (!component) {
+            continue;
+        }
+
+        component->m_staticInstanceFunction = staticPlugin.instance;
+
+        if (m_componentSearchList.contains(component->name())) {
+            component->m_loadFlags.setFlag(NameClash);
+        }
+
+        m_componentSearchList[component->name()] = component;
+        m_providersIndexed = false;
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::createPluginLoader(
+        Nedrysoft::ComponentSystem::Component *component) -> QPluginLoader * {
+
+    if (component->m_staticInstanceFunction) {
+        return nullptr;
+    }
+
+    return new QPluginLoader(component->filename());
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::componentInstance(
+        QPluginLoader *pluginLoader,
+        Nedrysoft::ComponentSystem::Component *component) -> Nedrysoft::ComponentSystem::IComponent * {
+
+    if (pluginLoader) {
+        return qobject_cast<Nedrysoft::ComponentSystem::IComponent *>(pluginLoader->instance());
+    }
+
+    return qobject_cast<Nedrysoft::ComponentSystem::IComponent *>(component->m_staticInstance.data());
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::releaseStaticInstance(
+        Nedrysoft::ComponentSystem::Component *component) -> void {
+
+    // this mirrors QPluginLoader::unload, which deletes the instance of a dynamic component, a new instance is
+    // created by the instance function if the component is loaded again
+
+    delete component->m_staticInstance.data();
+
+    component->m_staticInstance.clear();
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadLibrary(
+        Nedrysoft::ComponentSystem::Component *component,
+        QPluginLoader *pluginLoader) -> bool {
+
+    if (!pluginLoader) {
+        // static components are linked into the application
+
+        return component->m_staticInstanceFunction != nullptr;
+    }
+
+    auto startTime = m_timer.nsecsElapsed();
+
+    auto libraryLoaded = pluginLoader->load();
+
+    recordTiming(component->name(), LoadPhase::LibraryLoad, startTime);
+
+    return libraryLoaded;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::recordTiming(
+        const QString &name,
+        Nedrysoft::ComponentSystem::ComponentLoader::LoadPhase phase,
+        qint64 startTime) -> void {
+
+    // the flag is read without the lock as timings are recorded from the worker threads, it is checked again
+    // under the lock so that a timing is never added after timing has been disabled
+
+    if (!m_timingEnabled.loadAcquire()) {
+        return;
+    }
+
+    LoadTiming timing;
+
+    timing.name = name;
+    timing.phase = phase;
+    timing.startTime = startTime;
+    timing.duration = m_timer.nsecsElapsed() - startTime;
+    timing.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+
+    QMutexLocker locker(&m_timingMutex);
+
+    if (!m_timingEnabled.loadAcquire()) {
+        return;
+    }
+
+    m_loadTimings.append(timing);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::setTimingEnabled(bool enabled) -> void {
+    QMutexLocker locker(&m_timingMutex);
+
+    m_timingEnabled.storeRelease(enabled ? 1 : 0);
+
+    if (!enabled) {
+        m_loadTimings.clear();
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::loadTimings() -> QList<Nedrysoft::ComponentSystem::ComponentLoader::LoadTiming> {
+    QMutexLocker locker(&m_timingMutex);
+
+    return m_loadTimings;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentLoader::saveTrace(const QString &filename) -> bool {
+    auto metaEnum = QMetaEnum::fromType<Nedrysoft::ComponentSystem::ComponentLoader::LoadPhase>();
+    auto processId = static_cast<qint64>(QCoreApplication::applicationPid());
+
+    QHash<quintptr, int> threadIndex;
+    QJsonArray traceEvents;
+
+    for (const auto &timing : loadTimings()) {
+        if (!threadIndex.contains(timing.threadId)) {
+            threadIndex[timing.threadId] = threadIndex.count();
+        }
+
+        QJsonObject traceEvent;
+        QJsonObject traceArguments;
+
+        traceArguments["phase"] = QString::fromLatin1(metaEnum.valueToKey(static_cast<int>(timing.phase)));
+
+        traceEvent["name"] = timing.name;
+        traceEvent["cat"] = traceArguments["phase"];
+        traceEvent["ph"] = "X";
+        traceEvent["ts"] = static_cast<double>(timing.startTime) / NanosecondsPerMicrosecond;
+        traceEvent["dur"] = static_cast<double>(timing.duration) / NanosecondsPerMicrosecond;
+        traceEvent["pid"] = processId;
+        traceEvent["tid"] = threadIndex.value(timing.threadId);
+        traceEvent["args"] = traceArguments;
+
+        traceEvents.append(traceEvent);
+    }
+
+    QJsonObject traceObject;
+
+    traceObject["traceEvents"] = traceEvents;
+    traceObject["displayTimeUnit"] = "ms";
+
+    QSaveFile traceFile(filename);
+
+    if (!traceFile.open(QFile::WriteOnly)) {
+        return false;
+    }
+
+    traceFile.write(QJsonDocument(traceObject).toJson(QJsonDocument::Compact));
+
+    return traceFile.commit();
 }
 
 auto Nedrysoft::ComponentSystem::ComponentLoader::loadFlagString(
@@ -26,16 +26,35 @@
 
 #include "ComponentSystemSpec.h"
 
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QObject>
 #include <QPair>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
 #include <functional>
+#include <memory>
 
+class QFileInfo;
+class QFileSystemWatcher;
+class QJsonObject;
 class QPluginLoader;
+class QThreadPool;
+class QTimer;
+class QVersionNumber;
 
 namespace Nedrysoft { namespace ComponentSystem {
+    struct AsyncLoad;
     class Component;
+    class ComponentMetadataCache;
+    struct ComponentArena;
+    class IComponent;
+    struct ComponentFingerprint;
 
     /**
      * @brief       The ComponentLoader loads the discovered components.
@@ -67,12 +86,43 @@ namespace Nedrysoft { namespace ComponentSystem {
                 Disabled = 16,
                 IncompatibleVersion = 32,
                 UnableToLoad = 64,
-                MissingInterface = 128
+                MissingInterface = 128,
+                CircularDependency = 256,
+                Deferred = 512,
+                UnloadRequested = 1024
             };
             Q_ENUM(LoadFlag)
             Q_DECLARE_FLAGS(LoadFlags, LoadFlag)
             Q_FLAGS(LoadFlags)
 
+            /**
+             * @brief       The phases of the load pipeline that are timed.
+             */
+            enum class LoadPhase {
+                MetadataRead,
+                LibraryLoad,
+                InstanceCreation,
+                Initialise,
+                InitialisationFinished,
+                Finalise
+            };
+            Q_ENUM(LoadPhase)
+
+            /**
+             * @brief       The LoadTiming structure records the time taken by a phase of the load pipeline.
+             *
+             * @details     Times are in nanoseconds relative to the creation of the ComponentLoader.  The name is
+             *              the component name, except for metadata reads which are recorded against the
+             *              filename as the component name is not yet known.
+             */
+            struct LoadTiming {
+                QString name;
+                LoadPhase phase;
+                qint64 startTime;
+                qint64 duration;
+                quintptr threadId;
+            };
+
         public:
             /**
              * @brief       Constructs a ComponentLoader which is a child of the parent.
@@ -96,6 +146,153 @@ namespace Nedrysoft { namespace ComponentSystem {
              */
             auto addComponents(const QString &componentFolder) -> void;
 
+            /**
+             * @brief       Add all components in the given folders to the load list.
+             *
+             * @details     Searches each of the given directories and adds any loadable components to the list of
+             *              components to be loaded.  The metadata of the candidate files is read in parallel on a
+             *              bounded thread pool, the results are then merged in the order that the folders were
+             *              given (and in filename order within a folder), so that name clashes are always resolved
+             *              in the same way.
+             *
+             * @param[in]   componentFolders the list of search folders.
+             */
+            auto addComponents(const QStringList &componentFolders) -> void;
+
+            /**
+             * @brief       Adds the components listed in a manifest to the load list.
+             *
+             * @details     The manifest is memory mapped and read in a single pass, the folders are not listed and
+             *              the component libraries are not opened.  The load order stored in the manifest is used
+             *              by loadComponents instead of resolving the dependencies.
+             *
+             *              If the manifest is missing or stale (a folder or component file has changed since it
+             *              was written) then nothing is added and the application should fall back to
+             *              addComponents.
+             *
+             * @param[in]   filename the filename of the manifest.
+             *
+             * @returns     true if the components were added from the manifest; otherwise false.
+             */
+            auto addComponentsFromManifest(const QString &filename) -> bool;
+
+            /**
+             * @brief       Writes a manifest describing the discovered components.
+             *
+             * @details     The manifest lists the folders given to addComponents and the path, fingerprint and
+             *              metadata of every discovered (non static) component in load order.  It is typically
+             *              written by the ComponentManifest tool when an application is installed.
+             *
+             *              The manifest must not be written to one of the component folders.
+             *
+             * @param[in]   filename the filename of the manifest.
+             *
+             * @returns     true if the manifest was written; otherwise false.
+             */
+            auto saveManifest(const QString &filename) -> bool;
+
+            /**
+             * @brief       Writes a snapshot of the completed load.
+             *
+             * @details     The snapshot is a manifest that additionally records the load flags of every component
+             *              and the names of the components that were disabled by the load function, it allows
+             *              loadSnapshot to repeat the load without resolving it again.  The snapshot is normally
+             *              written after loadComponents has returned.
+             *
+             *              Static components are not part of a snapshot, and the snapshot must not be written to
+             *              one of the component folders.
+             *
+             * @param[in]   filename the filename of the snapshot.
+             *
+             * @returns     true if the snapshot was written; otherwise false.
+             */
+            auto saveSnapshot(const QString &filename) -> bool;
+
+            /**
+             * @brief       Repeats the load recorded in a snapshot.
+             *
+             * @details     The fingerprints of the component files and folders are checked in bulk, if nothing
+             *              has changed then the components are created from the snapshot and the recorded plan is
+             *              loaded in the recorded order, without listing the folders, opening the libraries to read
+             *              their metadata, validating the dependencies or resolving the load order.  Deferred
+             *              components are registered for activation as they would be by loadComponents.
+             *
+             *              The snapshot is rejected, and nothing is added or loaded, if it is missing or stale, if
+             *              the load function now disables a different set of components, if a component would now
+             *              be rejected for a reason that was not recorded (such as a different Qt version) or if
+             *              components have already been added to the loader.  The application should then fall
+             *              back to addComponents and loadComponents.
+             *
+             * @param[in]   filename the filename of the snapshot.
+             * @param[in]   loadFunction the application supplied load function; may be nullptr.
+             *
+             * @returns     true if the components were loaded from the snapshot; otherwise false.
+             */
+            auto loadSnapshot(
+                    const QString &filename,
+                    std::function<bool(Nedrysoft::ComponentSystem::Component *)> loadFunction = nullptr) -> bool;
+
+            /**
+             * @brief       Adds the components that are linked statically into the application to the load list.
+             *
+             * @details     Components are linked statically by building them as static plugins and importing
+             *              them with Q_IMPORT_PLUGIN, they are then resolved and receive the lifecycle events in
+             *              the same way as components discovered by addComponents but without the cost of
+             *              searching for, opening and resolving a shared library.
+             *
+             *              Any static plugin that does not implement the IComponent interface is ignored.
+             */
+            auto addStaticComponents() -> void;
+
+            /**
+             * @brief       Rescans the component folders and loads any new components.
+             *
+             * @details     Each folder previously given to addComponents is searched again, the metadata is read
+             *              only for files that are new or that have changed since they were last read.  The new
+             *              components (along with any components that were previously missing a dependency) are
+             *              then loaded using the load function that was last passed to loadComponents.
+             *
+             *              Components that are already loaded are not touched, a loaded component whose file has
+             *              changed remains loaded until the loader is unloaded.  Components that were unloaded by
+             *              unloadComponent are not loaded again.
+             *
+             * @note        Does nothing until components have been loaded, or while an asynchronous load is in
+             *              progress.
+             */
+            auto rescan() -> void;
+
+            /**
+             * @brief       Sets whether the component folders are watched for changes.
+             *
+             * @details     When enabled, changes to any of the component folders trigger a rescan once the folder
+             *              has stopped changing.
+             *
+             *              Watching is disabled by default.
+             *
+             * @param[in]   enabled true to watch the component folders; otherwise false.
+             */
+            auto setWatchEnabled(bool enabled) -> void;
+
+            /**
+             * @brief       Enables the persistent metadata cache.
+             *
+             * @details     Reading the metadata of a component requires the shared library to be opened and
+             *              scanned, when the cache is enabled the metadata of each file is stored (keyed by the
+             *              absolute path, size, modification time and inode of the file) so that unchanged files
+             *              do not need to be read again by subsequent calls to addComponents.
+             *
+             *              The cache file is typically placed next to the component folder, or in the location
+             *              returned by QStandardPaths::writableLocation(QStandardPaths::CacheLocation).  The cache
+             *              is rewritten after addComponents has been called if any entries have changed.
+             *
+             *              Passing an empty filename disables the cache.
+             *
+             * @note        This function should be called before addComponents.
+             *
+             * @param[in]   filename the filename of the cache file.
+             */
+            auto setMetadataCacheFilename(const QString &filename) -> void;
+
             /**
              * @brief       Loads all discovered components.
              *
@@ -104,6 +301,85 @@ namespace Nedrysoft { namespace ComponentSystem {
              */
             auto loadComponents(std::function<bool(Nedrysoft::ComponentSystem::Component *)> loadFunction = nullptr) -> void;
 
+            /**
+             * @brief       Discovers and loads components without blocking the calling thread.
+             *
+             * @details     The given folders are searched (in addition to any folders previously given to
+             *              addComponents), the dependencies are resolved and the component libraries loaded on a
+             *              worker thread.  The load function is called on the loader thread, the component
+             *              instances are created and the lifecycle events are delivered on the loader thread, in
+             *              the same order as loadComponents.
+             *
+             *              componentLoaded is emitted for every component as it is instantiated, progress is
+             *              emitted for every candidate and loadFinished is emitted once the lifecycle events have
+             *              been delivered.  Lazy components that are requested while the load is in progress are
+             *              activated once it has finished.
+             *
+             * @note        The loader thread must be running an event loop, and no other loader functions should
+             *              be called until loadFinished has been emitted.  Destroying the loader cancels the load
+             *              and waits for the worker to finish.
+             *
+             * @param[in]   componentFolders the list of search folders; may be empty.
+             * @param[in]   loadFunction the load function is a callback that allows the application to selectively
+             *              load components, i.e the user can disable certain components.
+             */
+            auto loadComponentsAsync(
+                    const QStringList &componentFolders,
+                    std::function<bool(Nedrysoft::ComponentSystem::Component *)> loadFunction = nullptr) -> void;
+
+            /**
+             * @brief       Sets whether component libraries are loaded concurrently.
+             *
+             * @details     When enabled, the resolved components are grouped into waves where each wave contains
+             *              the components whose dependencies were loaded by an earlier wave.  The libraries of
+             *              every component in a wave are then loaded concurrently, the component instances are
+             *              still created on the calling thread and the lifecycle events are delivered in the
+             *              same order as when loading serially.
+             *
+             *              Parallel loading is disabled by default.
+             *
+             * @note        This function should be called before loadComponents.
+             *
+             * @param[in]   enabled true to load libraries concurrently; otherwise false.
+             */
+            auto setParallelLoading(bool enabled) -> void;
+
+            /**
+             * @brief       Sets whether the components are torn down for a fast process exit.
+             *
+             * @details     In fast exit mode unloadComponents (and the destructor of the loader) only call the
+             *              finaliseEvent of the components that set "FinaliseOnExit" to true in their metadata,
+             *              the libraries are not unloaded and the plugin loaders and components are not deleted,
+             *              so no library static destructors run until the process exits.  The object registry is
+             *              left intact and is torn down with the process.
+             *
+             *              Fast exit is disabled by default and is intended to be enabled just before the
+             *              application exits, unloadComponent is not affected.
+             *
+             * @param[in]   enabled true to enable fast exit; otherwise false.
+             */
+            auto setFastExit(bool enabled) -> void;
+
+            /**
+             * @brief       Activates a deferred component.
+             *
+             * @details     Components that declare "Activation": "Lazy" in their metadata are not loaded by
+             *              loadComponents (unless a component that is loaded depends on them), instead they are
+             *              activated the first time that an object implementing one of the interfaces listed in
+             *              their "Provides" metadata is requested from the registry.
+             *
+             *              Activation loads any deferred dependencies (in dependency order) followed by the
+             *              component itself, and then delivers the lifecycle events to the newly loaded components.
+             *              Deferred providers of the interfaces listed in the "Consumes" metadata of the component
+             *              are activated along with it, ahead of the component.
+             *
+             *              If called from a thread other than the thread of the loader, activation is performed on
+             *              the loader thread and this function blocks until it has finished.
+             *
+             * @param[in]   component the component to activate.
+             */
+            auto activateComponent(Nedrysoft::ComponentSystem::Component *component) -> void;
+
             /**
              * @brief       Returns the list of all discovered components.
              *
@@ -116,40 +392,575 @@ namespace Nedrysoft { namespace ComponentSystem {
              */
             auto components() -> QList<Component *>;
 
+            /**
+             * @brief       Returns the components that provide the given interface.
+             *
+             * @details     The providers are taken from the "Provides" metadata of the discovered components, so
+             *              they are known before any component has been loaded.
+             *
+             * @param[in]   interfaceName the IID of the interface.
+             *
+             * @returns     the list of components that provide the interface.
+             */
+            auto providers(const QString &interfaceName) -> QList<Nedrysoft::ComponentSystem::Component *>;
+
             /**
              * @brief       Unloads all loaded components.
              */
             auto unloadComponents() -> void;
 
+            /**
+             * @brief       Unloads a component and the components that depend on it.
+             *
+             * @details     The components that depend (directly or indirectly) on the component are found using
+             *              the reverse dependency graph, finaliseEvent is called on each of them in reverse load
+             *              order and their libraries are then released.  Other components remain loaded.
+             *
+             *              The unloaded components are flagged with UnloadRequested so that they are not loaded
+             *              again by rescan, an unloaded component can be loaded again by calling loadComponents.
+             *
+             * @param[in]   component the component to unload.
+             */
+            auto unloadComponent(Nedrysoft::ComponentSystem::Component *component) -> void;
+
+            /**
+             * @brief       Sets whether the timings of the load pipeline are recorded.
+             *
+             * @details     Timing is disabled by default, as the recorded timings are kept until timing is disabled
+             *              again.  Disabling timing discards the timings that have been recorded.
+             *
+             * @note        This function should be called before addComponents.
+             *
+             * @param[in]   enabled true to record timings; otherwise false.
+             */
+            auto setTimingEnabled(bool enabled) -> void;
+
+            /**
+             * @brief       Returns the timings recorded for the load pipeline.
+             *
+             * @details     When timing is enabled, a timing is recorded for the metadata read of each candidate file
+             *              in addComponents, and for the library load, instance creation, initialiseEvent,
+             *              initialisationFinishedEvent and finaliseEvent of each component.
+             *
+             * @returns     the list of timings in the order they were recorded.
+             */
+            auto loadTimings() -> QList<Nedrysoft::ComponentSystem::ComponentLoader::LoadTiming>;
+
+            /**
+             * @brief       Saves the recorded timings as a trace file.
+             *
+             * @details     The trace uses the Chrome trace event JSON format, which can be opened in
+             *              chrome://tracing or the Perfetto UI.
+             *
+             * @param[in]   filename the filename of the trace file.
+             *
+             * @returns     true if the trace was saved; otherwise false.
+             */
+            auto saveTrace(const QString &filename) -> bool;
+
+            /**
+             * @brief       This signal is emitted when a component has been instantiated by loadComponentsAsync.
+             *
+             * @param[in]   component the component that was loaded.
+             */
+            Q_SIGNAL void componentLoaded(Nedrysoft::ComponentSystem::Component *component);
+
+            /**
+             * @brief       This signal is emitted as loadComponentsAsync processes each component.
+             *
+             * @param[in]   current the number of components processed so far.
+             * @param[in]   total the number of components to process.
+             */
+            Q_SIGNAL void progress(int current, int total);
+
+            /**
+             * @brief       This signal is emitted when loadComponentsAsync has finished.
+             */
+            Q_SIGNAL void loadFinished();
+
         private:
             /**
-             * @brief       Resolves the dependencies of the loaded components.
+             * @brief       Adds folders to the list of folders that are searched for components.
              *
-             * @details     For a given component, returns a list of components in the order that they must be loaded
-             *              in order to satisfy all component and sub component dependencies.
+             * @param[in]   componentFolders the list of search folders.
+             */
+            auto addComponentFolders(const QStringList &componentFolders) -> void;
+
+            /**
+             * @brief       Searches the given folders and adds the discovered components to the search list.
              *
-             * @param[in]   component the component to resolve.
-             * @param[out]  resolvedList the ordered list of components.
+             * @param[in]   componentFolders the list of search folders.
              */
-            auto resolve(Nedrysoft::ComponentSystem::Component *component,
-                         QList<Nedrysoft::ComponentSystem::Component *> &resolvedList) -> void;
+            auto discoverComponents(const QStringList &componentFolders) -> void;
 
             /**
-             * @brief           Resolves the dependencies of the loaded components.
+             * @brief       Removes the entries of deleted files from the metadata cache and saves it.
              *
-             * @details         For a given component, returns a list of components in the order that they must be
-             *                  loaded in order to satisfy all component and sub component dependencies.
+             * @note        This function is thread safe.
+             *
+             * @param[in]   componentFolders the list of folders that were searched.
+             */
+            auto pruneMetadataCache(const QStringList &componentFolders) -> void;
+
+            /**
+             * @brief       Clears the UnloadRequested flag of every discovered component.
+             */
+            auto clearUnloadRequests() -> void;
+
+            /**
+             * @brief       Loads the discovered components that are not flagged.
+             *
+             * @details     Implements loadComponents, without clearing the UnloadRequested flags.
+             *
+             * @param[in]   loadFunction the application supplied load function; may be nullptr.
+             */
+            auto loadDiscoveredComponents(
+                    const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> void;
+
+            /**
+             * @brief       Links the dependencies of the unloaded components and resolves the load order.
+             *
+             * @returns     the components that are not yet loaded, in dependency order.
+             */
+            auto resolveLoadList() -> QList<Nedrysoft::ComponentSystem::Component *>;
+
+            /**
+             * @brief       Returns the metadata embedded in a component file.
+             *
+             * @details     If the metadata cache is enabled and holds an up to date entry for the file then the
+             *              cached metadata is returned, otherwise the metadata is read from the file.
+             *
+             * @param[in]   fileInfo the component file.
+             *
+             * @returns     the metadata of the component; an empty object if the file has no metadata.
+             */
+            auto readMetadata(const QFileInfo &fileInfo) -> QJsonObject;
+
+            /**
+             * @brief       Returns the loadable files in the given folders.
+             *
+             * @param[in]   componentFolders the list of search folders.
+             *
+             * @returns     the files, in folder order and then filename order within each folder.
+             */
+            auto findCandidateFiles(const QStringList &componentFolders) -> QList<QFileInfo>;
+
+            /**
+             * @brief       Reads the metadata of the given files and adds the components to the search list.
+             *
+             * @details     The metadata of the candidate files is read in parallel, the results are merged in the
+             *              order of the list so that name clashes are always resolved in the same way.
+             *
+             * @param[in]   candidateFiles the files to add.
+             */
+            auto addCandidateFiles(const QList<QFileInfo> &candidateFiles) -> void;
+
+            /**
+             * @brief       Reads the metadata of the given files in parallel.
              *
-             *                  This overload uses a list to mark nodes as already processed, this allows us to detect
-             *                  circular references.
+             * @note        This function is thread safe.
+             *
+             * @param[in]   candidateFiles the files to read.
+             *
+             * @returns     the metadata of each file, in the order of the list.
+             */
+            auto readCandidateMetadata(const QList<QFileInfo> &candidateFiles) -> QVector<QJsonObject>;
+
+            /**
+             * @brief       Adds the components described by metadata that has already been read to the search list.
+             *
+             * @param[in]   candidateFiles the files to add.
+             * @param[in]   candidateMetadata the metadata of each file, in the order of the list.
+             */
+            auto addCandidateFiles(
+                    const QList<QFileInfo> &candidateFiles,
+                    const QVector<QJsonObject> &candidateMetadata) -> void;
+
+            /**
+             * @brief       Removes the component created from the given file from the search list.
+             *
+             * @details     Loaded and deferred components are never removed, a removed component is released
+             *              back to the arena.
+             *
+             * @param[in]   componentFilename the absolute filename of the component.
+             *
+             * @returns     true if no component is using the file any more; otherwise false.
+             */
+            auto retireComponent(const QString &componentFilename) -> bool;
+
+            /**
+             * @brief       Releases an unloaded component so that its slot in the arena can be reused.
+             *
+             * @details     The dependency edges to and from the component are removed and the slot is reset to an
+             *              empty component, the component must not be in the search list.
+             *
+             * @param[in]   component the component to release.
+             */
+            auto releaseComponent(Nedrysoft::ComponentSystem::Component *component) -> void;
+
+            /**
+             * @brief       Releases a list of unloaded components.
+             *
+             * @param[in]   components the components to release.
+             */
+            auto releaseComponents(const QList<Nedrysoft::ComponentSystem::Component *> &components) -> void;
+
+            /**
+             * @brief       Creates a component from the metadata of a component file.
+             *
+             * @details     Checks that the metadata describes a component that is compatible with the application
+             *              build, the qt version of the component is checked and the component flagged if it is not
+             *              compatible.
+             *
+             * @param[in]   componentFilename the filename of the component.
+             * @param[in]   metaDataObject the metadata read from the component file.
+             * @param[in]   applicationDebugBuild true if debug components should be loaded; otherwise false.
+             * @param[in]   applicationQtVersion the qt version that the application is using.
+             *
+             * @returns     the new component; nullptr if the file is not a valid component.
+             */
+            auto createComponent(
+                    const QString &componentFilename,
+                    const QJsonObject &metaDataObject,
+                    bool applicationDebugBuild,
+                    const QVersionNumber &applicationQtVersion) -> Nedrysoft::ComponentSystem::Component *;
+
+            /**
+             * @brief       Returns the shared instance of a string from the pool of this loader.
+             *
+             * @note        Must be called on the loader thread.
+             *
+             * @param[in]   string the string to intern.
+             *
+             * @returns     the interned string.
+             */
+            auto internString(const QString &string) -> QString;
+
+            /**
+             * @brief       Interns the strings of a new component that are repeated across components.
+             *
+             * @note        Must be called on the loader thread.
+             *
+             * @param[in]   component the component.
+             */
+            auto internStrings(Nedrysoft::ComponentSystem::Component *component) -> void;
+
+            /**
+             * @brief       Calls a function for each index in a range using the loader thread pool.
+             *
+             * @details     The function is called concurrently and must be thread safe, this function returns once
+             *              every index has been processed.
+             *
+             * @param[in]   count the number of indices.
+             * @param[in]   function the function to call with each index.
+             */
+            auto parallelFor(int count, const std::function<void(int)> &function) -> void;
+
+            /**
+             * @brief       Checks whether a component is able to be loaded.
+             *
+             * @details     Ensures that the component has no error flags set, that its dependencies were loaded
+             *              and that the application has not disabled it.
+             *
+             * @param[in]   component the component to check.
+             * @param[in]   loadFunction the application supplied load function; may be nullptr.
+             *
+             * @returns     true if the component should be loaded; otherwise false.
+             */
+            auto canLoadComponent(
+                    Nedrysoft::ComponentSystem::Component *component,
+                    const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> bool;
+
+            /**
+             * @brief       Defers the loading of components that are activated on demand.
+             *
+             * @details     A lazy component is deferred unless a component that is being loaded now depends on it,
+             *              an activator is registered with the object registry for each interface it provides.
+             *
+             * @param[in]   resolvedLoadList the components in dependency order.
+             * @param[in]   loadFunction the application supplied load function; may be nullptr.
+             */
+            auto deferLazyComponents(
+                    const QList<Nedrysoft::ComponentSystem::Component *> &resolvedLoadList,
+                    const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> void;
+
+            /**
+             * @brief       Registers an activator for each interface that a deferred component provides.
+             *
+             * @param[in]   component the deferred component.
+             */
+            auto addActivators(Nedrysoft::ComponentSystem::Component *component) -> void;
+
+            /**
+             * @brief       Writes a manifest or snapshot describing the discovered components.
+             *
+             * @param[in]   filename the filename of the manifest.
+             * @param[in]   isSnapshot true if the load flags and disabled components should be recorded.
+             *
+             * @returns     true if the manifest was written; otherwise false.
+             */
+            auto writeManifest(const QString &filename, bool isSnapshot) -> bool;
+
+            /**
+             * @brief       Delivers the lifecycle events to newly loaded components.
+             *
+             * @details     Calls initialiseEvent (in load order) and then initialisationFinishedEvent (in reverse
+             *              load order) on each component in the load order starting from the given index.  If any
+             *              of the components opted in to concurrent initialisation then those components receive
+             *              initialiseEvent in concurrent batches, initialisationFinishedEvent is always delivered
+             *              serially once every initialiseEvent has returned.
+             *
+             *              Components that are appended to the load order while the events are delivered (i.e
+             *              lazy components activated by an initialiseEvent) are not visited.
+             *
+             * @param[in]   firstLoadIndex the index in the load order of the first newly loaded component.
+             */
+            auto initialiseComponents(int firstLoadIndex) -> void;
+
+            /**
+             * @brief       Records the mapped image size of newly loaded components.
+             *
+             * @details     The process mappings are read once for all of the components, on platforms where they
+             *              are available.
+             *
+             * @param[in]   firstLoadIndex the index in the load order of the first newly loaded component.
+             * @param[in]   lastLoadIndex the index in the load order after the last newly loaded component.
+             */
+            auto updateImageSizes(int firstLoadIndex, int lastLoadIndex) -> void;
+
+            /**
+             * @brief       Calls initialiseEvent on a loaded component.
+             *
+             * @note        This function is thread safe.
+             *
+             * @param[in]   pluginLoader the plugin loader for the component; nullptr if the component is static.
+             * @param[in]   component the component.
+             */
+            auto initialiseComponent(
+                    QPluginLoader *pluginLoader,
+                    Nedrysoft::ComponentSystem::Component *component) -> void;
+
+            /**
+             * @brief       Calls initialiseEvent on newly loaded components, initialising the opted in components
+             *              concurrently.
+             *
+             * @details     Used when at least one of the components has opted in to concurrent initialisation.  The
+             *              components are visited in load order, consecutive opted in components that do not depend
+             *              on each other are initialised together on the thread pool.  The remaining components are
+             *              initialised on the calling thread in load order, never while a batch is running.
+             *
+             *              Lazy components activated by a concurrent initialiseEvent are activated on the calling
+             *              thread while it waits for the batch, which is woken by the activation request.
+             *
+             * @param[in]   firstLoadIndex the index in the load order of the first newly loaded component.
+             * @param[in]   lastLoadIndex the index in the load order after the last newly loaded component.
+             */
+            auto initialiseComponentLevels(int firstLoadIndex, int lastLoadIndex) -> void;
+
+            /**
+             * @brief       Creates the instance of a component whose library has been loaded.
+             *
+             * @details     On success the component is added to the load order, on failure the plugin loader is
+             *              deleted and the component is flagged with the reason.
+             *
+             * @param[in]   component the component.
+             * @param[in]   pluginLoader the plugin loader for the component; nullptr if the component is static.
+             * @param[in]   libraryLoaded the result of QPluginLoader::load.
+             *
+             * @returns     true if the component was loaded; otherwise false.
+             */
+            auto instantiateComponent(
+                    Nedrysoft::ComponentSystem::Component *component,
+                    QPluginLoader *pluginLoader,
+                    bool libraryLoaded) -> bool;
+
+            /**
+             * @brief       Loads the resolved components in waves of independent components.
+             *
+             * @param[in]   resolvedLoadList the components in dependency order.
+             * @param[in]   loadFunction the application supplied load function; may be nullptr.
+             */
+            auto loadComponentWaves(
+                    const QList<Nedrysoft::ComponentSystem::Component *> &resolvedLoadList,
+                    const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> void;
+
+            /**
+             * @brief       Groups the resolved components into waves of independent components.
+             *
+             * @details     Every component is placed in the wave after the last wave that contains one of its
+             *              dependencies.
+             *
+             * @param[in]   resolvedLoadList the components in dependency order.
+             *
+             * @returns     the indices (into the resolved list) of the components in each wave.
+             */
+            auto loadWaves(
+                    const QList<Nedrysoft::ComponentSystem::Component *> &resolvedLoadList) -> QList<QList<int> >;
+
+            /**
+             * @brief       Sorts the load order entries added by a load back into resolved order.
+             *
+             * @param[in]   firstLoadIndex the index of the first load order entry added by the load.
+             * @param[in]   resolvedLoadList the components in dependency order.
+             */
+            auto restoreLoadOrder(
+                    int firstLoadIndex,
+                    const QList<Nedrysoft::ComponentSystem::Component *> &resolvedLoadList) -> void;
+
+            /**
+             * @brief       Adds the discovered components of an asynchronous load and decides which to load.
+             *
+             * @details     Called on the loader thread once the worker has read the metadata, the libraries are
+             *              then loaded on the worker.
+             *
+             * @param[in]   asyncLoad the state of the load.
+             * @param[in]   loadFunction the application supplied load function; may be nullptr.
+             */
+            auto resolveAsyncLoad(
+                    const std::shared_ptr<Nedrysoft::ComponentSystem::AsyncLoad> &asyncLoad,
+                    const std::function<bool(Nedrysoft::ComponentSystem::Component *)> &loadFunction) -> void;
+
+            /**
+             * @brief       Loads the libraries of an asynchronous load on the worker.
+             *
+             * @details     The instantiation of each component is posted to the loader thread once its library
+             *              has been loaded, when parallel loading is enabled the libraries are loaded a wave at a
+             *              time.
+             *
+             * @param[in]   asyncLoad the state of the load.
+             */
+            auto loadAsyncLibraries(const std::shared_ptr<Nedrysoft::ComponentSystem::AsyncLoad> &asyncLoad) -> void;
+
+            /**
+             * @brief       Creates the instance of a component whose library was loaded by an asynchronous load.
+             *
+             * @param[in]   asyncLoad the state of the load.
+             * @param[in]   loadIndex the index of the component in the resolved list.
+             */
+            auto instantiateAsyncComponent(
+                    const std::shared_ptr<Nedrysoft::ComponentSystem::AsyncLoad> &asyncLoad,
+                    int loadIndex) -> void;
+
+            /**
+             * @brief       Delivers the lifecycle events once every component of an asynchronous load is instantiated.
+             *
+             * @param[in]   asyncLoad the state of the load.
+             */
+            auto finishAsyncLoad(const std::shared_ptr<Nedrysoft::ComponentSystem::AsyncLoad> &asyncLoad) -> void;
+
+            /**
+             * @brief       The visit state of a component during dependency resolution.
+             */
+            enum class ResolveState {
+                Unvisited,
+                Visiting,
+                Resolved
+            };
+
+            /**
+             * @brief       Resolves the dependencies of the given components.
+             *
+             * @details     Performs a single depth first topological sort over the dependency graph of all of the
+             *              given components, returning the components in the order that they must be loaded in
+             *              order to satisfy all component and sub component dependencies.
+             *
+             *              Circular dependencies are reported with the full cycle path, and every component that
+             *              is part of the cycle is flagged with CircularDependency.
+             *
+             * @param[in]   components the components to resolve.
+             *
+             * @returns     the ordered list of components.
+             */
+            auto resolve(const QList<Nedrysoft::ComponentSystem::Component *> &components) ->
+                    QList<Nedrysoft::ComponentSystem::Component *>;
+
+            /**
+             * @brief       Adds a component to be activated, preceded by the deferred providers that it consumes.
+             *
+             * @details     The providers are visited depth first so that a provider is always added before the
+             *              components that consume it, visited components are skipped so cycles terminate.
+             *
+             * @param[in]       component the component to activate.
+             * @param[in,out]   activationList the list of components to activate.
+             * @param[in,out]   visitedComponents the components that have already been visited.
+             */
+            auto addActivation(
+                    Nedrysoft::ComponentSystem::Component *component,
+                    QList<Nedrysoft::ComponentSystem::Component *> &activationList,
+                    QSet<Nedrysoft::ComponentSystem::Component *> &visitedComponents) -> void;
+
+            /**
+             * @brief           Resolves the dependencies of a component.
+             *
+             * @details         Visits the dependencies of the component depth first and then appends the component
+             *                  to the resolved list.  Components currently being visited form the resolve path, a
+             *                  dependency that is already on the path indicates a circular dependency.
              *
              * @param[in]       component the component to resolve.
-             * @param[in,out]   processedList list of nodes that have already been processed.
-             * @param[out]      resolvedList ordered list of components.
+             * @param[in,out]   resolvedList ordered list of components.
+             * @param[in,out]   resolveState the visit state of each component.
+             * @param[in,out]   resolvePath the components currently being visited.
              */
             auto resolve(Nedrysoft::ComponentSystem::Component *component,
                          QList<Nedrysoft::ComponentSystem::Component *> &resolvedList,
-                         QList<Nedrysoft::ComponentSystem::Component *> &processedList) -> void;
+                         QHash<Nedrysoft::ComponentSystem::Component *, ResolveState> &resolveState,
+                         QList<Nedrysoft::ComponentSystem::Component *> &resolvePath) -> void;
+
+            /**
+             * @brief       Creates the plugin loader for a component.
+             *
+             * @param[in]   component the component.
+             *
+             * @returns     the plugin loader; nullptr if the component is static.
+             */
+            auto createPluginLoader(Nedrysoft::ComponentSystem::Component *component) -> QPluginLoader *;
+
+            /**
+             * @brief       Returns the instance of a loaded component.
+             *
+             * @param[in]   pluginLoader the plugin loader for the component; nullptr if the component is static.
+             * @param[in]   component the component.
+             *
+             * @returns     the component interface; nullptr if there is no instance.
+             */
+            auto componentInstance(
+                    QPluginLoader *pluginLoader,
+                    Nedrysoft::ComponentSystem::Component *component) -> Nedrysoft::ComponentSystem::IComponent *;
+
+            /**
+             * @brief       Deletes the instance of an unloaded static component.
+             *
+             * @param[in]   component the component.
+             */
+            auto releaseStaticInstance(Nedrysoft::ComponentSystem::Component *component) -> void;
+
+            /**
+             * @brief       Loads the library of a component and records the time taken.
+             *
+             * @note        This function is thread safe.
+             *
+             * @param[in]   component the component.
+             * @param[in]   pluginLoader the plugin loader for the component; nullptr if the component is static.
+             *
+             * @returns     the result of QPluginLoader::load; true for a static component.
+             */
+            auto loadLibrary(Nedrysoft::ComponentSystem::Component *component, QPluginLoader *pluginLoader) -> bool;
+
+            /**
+             * @brief       Records the timing of a phase of the load pipeline which ends now.
+             *
+             * @details     Does nothing unless timing is enabled.
+             *
+             * @note        This function is thread safe.
+             *
+             * @param[in]   name the component name (or filename).
+             * @param[in]   phase the phase that was timed.
+             * @param[in]   startTime the time (from the loader timer) that the phase started.
+             */
+            auto recordTiming(
+                    const QString &name,
+                    Nedrysoft::ComponentSystem::ComponentLoader::LoadPhase phase,
+                    qint64 startTime) -> void;
 
             /**
              * @brief       Returns a string containing the flags that were set.
@@ -165,6 +976,33 @@ namespace Nedrysoft { namespace ComponentSystem {
 
             QList<QPair<QPluginLoader *, Nedrysoft::ComponentSystem::Component *> > m_loadOrder;
             QMap<QString, Nedrysoft::ComponentSystem::Component *> m_componentSearchList;
+            Nedrysoft::ComponentSystem::ComponentMetadataCache *m_metadataCache;
+            QThreadPool *m_threadPool;
+            QThreadPool *m_asyncThreadPool;
+            QAtomicInt m_asyncCancelled;
+            bool m_parallelLoading;
+            bool m_fastExit;
+
+            QStringList m_componentFolders;
+            QHash<QString, Nedrysoft::ComponentSystem::ComponentFingerprint> m_fileFingerprints;
+            std::function<bool(Nedrysoft::ComponentSystem::Component *)> m_loadFunction;
+            QFileSystemWatcher *m_fileSystemWatcher;
+            QTimer *m_rescanTimer;
+            bool m_asyncLoading;
+            bool m_componentsLoaded;
+            QList<Nedrysoft::ComponentSystem::Component *> m_pendingActivations;
+            QSet<QString> m_staticComponentFilenames;
+            QHash<QString, QList<Nedrysoft::ComponentSystem::Component *> > m_interfaceProviders;
+            bool m_providersIndexed;
+            bool m_concurrentInitialisation;
+            QList<Nedrysoft::ComponentSystem::Component *> m_manifestLoadOrder;
+            Nedrysoft::ComponentSystem::ComponentArena *m_componentArena;
+            QSet<QString> m_internedStrings;
+
+            QElapsedTimer m_timer;
+            QAtomicInt m_timingEnabled;
+            QMutex m_timingMutex;
+            QList<Nedrysoft::ComponentSystem::ComponentLoader::LoadTiming> m_loadTimings;
 
             //! @endcond
     };
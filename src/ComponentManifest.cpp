@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ComponentManifest.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborValue>
+#endif
+
+constexpr quint32 ManifestMagic = 0x4E43534D;   // "NCSM"
+constexpr quint32 ManifestVersion = 4;
+constexpr quint32 ManifestMinimumVersion = 1;   // version 1 manifests have no snapshot information
+constexpr quint32 ManifestInodeVersion = 2;     // manifests up to version 2 store the inode of each file
+constexpr quint32 ManifestJsonVersion = 4;      // manifests from version 4 store the metadata as compact json
+
+namespace {
+    /**
+     * @brief       Returns the modification time of a folder.
+     *
+     * @param[in]   path the path of the folder.
+     *
+     * @returns     the modification time in milliseconds since the epoch.
+     */
+    auto folderModified(const QString &path) -> qint64 {
+        return QFileInfo(path).lastModified().toMSecsSinceEpoch();
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::read(const QString &filename) -> bool {
+    m_folders.clear();
+    m_entries.clear();
+    m_disabledComponents.clear();
+    m_isSnapshot = false;
+
+    QFile manifestFile(filename);
+
+    if (!manifestFile.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    auto manifestSize = manifestFile.size();
+    auto manifestData = manifestFile.map(0, manifestSize);
+
+    if (!manifestData) {
+        return false;
+    }
+
+    // the stream reads directly from the mapped file
+
+    auto manifestBytes = QByteArray::fromRawData(
+            reinterpret_cast<const char *>(manifestData),
+            static_cast<int>(manifestSize));
+
+    QDataStream stream(manifestBytes);
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version, folderCount, entryCount;
+
+    stream >> magic >> version;
+
+    if (( stream.status() != QDataStream::Ok ) || ( magic != ManifestMagic ) ||
+        ( version < ManifestMinimumVersion ) || ( version > ManifestVersion )) {
+
+        return false;
+    }
+
+    // earlier versions store the metadata as cbor, which can only be decoded with qt 5.12 or later, otherwise the
+    // manifest is treated as unreadable and the application falls back to a normal scan
+
+#if QT_VERSION < QT_VERSION_CHECK(5, 12, 0)
+    if (version < ManifestJsonVersion) {
+        return false;
+    }
+#endif
+
+    if (version >= 2) {
+        stream >> m_isSnapshot;
+    }
+
+    auto manifestDir = QFileInfo(filename).absoluteDir();
+
+    stream >> folderCount;
+
+    for (quint32 folderIndex = 0; ( folderIndex < folderCount ) && ( stream.status() == QDataStream::Ok ); folderIndex++) {
+        Folder folder;
+
+        stream >> folder.path >> folder.modified;
+
+        folder.path = QDir::cleanPath(manifestDir.absoluteFilePath(folder.path));
+
+        m_folders.append(folder);
+    }
+
+    stream >> entryCount;
+
+    for (quint32 entryIndex = 0; ( entryIndex < entryCount ) && ( stream.status() == QDataStream::Ok ); entryIndex++) {
+        Entry entry;
+        QByteArray metadata;
+
+        stream >> entry.filename >> entry.fingerprint.size >> entry.fingerprint.modified;
+
+        if (version <= ManifestInodeVersion) {
+            quint64 inode;
+
+            stream >> inode;
+        }
+
+        stream >> metadata;
+
+        if (version >= 2) {
+            stream >> entry.loadFlags;
+        }
+
+        entry.filename = QDir::cleanPath(manifestDir.absoluteFilePath(entry.filename));
+
+        if (version >= ManifestJsonVersion) {
+            entry.metadata = QJsonDocument::fromJson(metadata).object();
+        } else {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+            entry.metadata = QCborValue::fromCbor(metadata).toJsonValue().toObject();
+#endif
+        }
+
+        m_entries.append(entry);
+    }
+
+    if (version >= 2) {
+        stream >> m_disabledComponents;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        m_folders.clear();
+        m_entries.clear();
+        m_disabledComponents.clear();
+        m_isSnapshot = false;
+
+        return false;
+    }
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::write(const QString &filename) const -> bool {
+    auto manifestDir = QFileInfo(filename).absoluteDir();
+
+    // writing the manifest would change the modification time of the folder, making the manifest stale as soon
+    // as it had been written
+
+    for (const auto &folder : m_folders) {
+        if (QDir::cleanPath(manifestDir.absolutePath()) == QDir::cleanPath(folder.path)) {
+            return false;
+        }
+    }
+
+    QSaveFile manifestFile(filename);
+
+    if (!manifestFile.open(QFile::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&manifestFile);
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << ManifestMagic << ManifestVersion << m_isSnapshot;
+
+    stream << static_cast<quint32>(m_folders.count());
+
+    for (const auto &folder : m_folders) {
+        stream << manifestDir.relativeFilePath(folder.path) << folder.modified;
+    }
+
+    stream << static_cast<quint32>(m_entries.count());
+
+    for (const auto &entry : m_entries) {
+        stream << manifestDir.relativeFilePath(entry.filename) << entry.fingerprint.size << entry.fingerprint.modified
+               << QJsonDocument(entry.metadata).toJson(QJsonDocument::Compact) << entry.loadFlags;
+    }
+
+    stream << m_disabledComponents;
+
+    return manifestFile.commit();
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::isStale() const -> bool {
+    for (const auto &folder : m_folders) {
+        if (folderModified(folder.path) != folder.modified) {
+            return true;
+        }
+    }
+
+    // the size and modification time are enough to detect a changed file, the inode is not stored in a manifest
+    // so that an installation can be copied or restored from a backup
+
+    for (const auto &entry : m_entries) {
+        QFileInfo fileInfo(entry.filename);
+
+        if (( fileInfo.size() != entry.fingerprint.size ) ||
+            ( fileInfo.lastModified().toMSecsSinceEpoch() != entry.fingerprint.modified )) {
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::addFolder(const QString &path) -> void {
+    Folder folder;
+
+    folder.path = QDir(path).absolutePath();
+    folder.modified = folderModified(path);
+
+    m_folders.append(folder);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::addEntry(
+        const QString &filename,
+        const Nedrysoft::ComponentSystem::ComponentFingerprint &fingerprint,
+        const QJsonObject &metadata,
+        int loadFlags) -> void {
+
+    Entry entry;
+
+    entry.filename = filename;
+    entry.fingerprint = fingerprint;
+    entry.fingerprint.inode = 0;
+    entry.metadata = metadata;
+    entry.loadFlags = loadFlags;
+
+    m_entries.append(entry);
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::setSnapshot(bool isSnapshot) -> void {
+    m_isSnapshot = isSnapshot;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::isSnapshot() const -> bool {
+    return m_isSnapshot;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::setDisabledComponents(const QStringList &disabledComponents) -> void {
+    m_disabledComponents = disabledComponents;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::disabledComponents() const -> QStringList {
+    return m_disabledComponents;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::folders() const -> QList<Nedrysoft::ComponentSystem::ComponentManifest::Folder> {
+    return m_folders;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentManifest::entries() const -> QList<Nedrysoft::ComponentSystem::ComponentManifest::Entry> {
+    return m_entries;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_COMPONENTSYSTEM_COMPONENTMANIFEST_H
+#define NEDRYSOFT_COMPONENTSYSTEM_COMPONENTMANIFEST_H
+
+#include "ComponentMetadataCache.h"
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace Nedrysoft { namespace ComponentSystem {
+    /**
+     * @brief       The ComponentManifest describes the components of an installation.
+     *
+     * @details     A manifest lists the component folders of an installation along with the path, fingerprint and
+     *              metadata of every component in the order that they must be loaded.  The manifest is written
+     *              once (typically at install time) and allows the loader to discover all components with a single
+     *              read of a memory mapped file, without listing the folders, checking each file or opening the
+     *              libraries to read their metadata.
+     *
+     *              Paths are stored relative to the manifest file so that an installation can be relocated,
+     *              and files are identified by their size and modification time only.  The manifest must not
+     *              be placed in one of the component folders.
+     *
+     *              A manifest may also be a snapshot of a completed load, in which case the load flags of each
+     *              component and the names of the disabled components are stored as well.
+     *
+     * @class       Nedrysoft::ComponentSystem::ComponentManifest ComponentManifest.h <ComponentManifest>
+     */
+    class ComponentManifest {
+        public:
+            /**
+             * @brief       A component folder and its modification time.
+             */
+            struct Folder {
+                QString path;
+                qint64 modified = -1;
+            };
+
+            /**
+             * @brief       A component file, its fingerprint and its metadata.
+             */
+            struct Entry {
+                QString filename;
+                ComponentFingerprint fingerprint;
+                QJsonObject metadata;
+                int loadFlags = 0;
+            };
+
+        public:
+            /**
+             * @brief       Reads a manifest from disk.
+             *
+             * @details     The manifest file is memory mapped while it is decoded, a missing, unreadable or
+             *              incompatible manifest results in an empty manifest.
+             *
+             * @param[in]   filename the filename of the manifest.
+             *
+             * @returns     true if the manifest was read; otherwise false.
+             */
+            auto read(const QString &filename) -> bool;
+
+            /**
+             * @brief       Writes the manifest to disk.
+             *
+             * @details     A manifest cannot be written to one of its component folders, as writing it would
+             *              change the modification time of the folder and the manifest would always be stale.
+             *
+             * @param[in]   filename the filename of the manifest.
+             *
+             * @returns     true if the manifest was written; otherwise false.
+             */
+            auto write(const QString &filename) const -> bool;
+
+            /**
+             * @brief       Checks whether the installation has changed since the manifest was written.
+             *
+             * @details     The manifest is stale if the modification time of any folder has changed (i.e a file
+             *              has been added or removed) or if the size or modification time of any component file
+             *              has changed.
+             *
+             * @returns     true if the manifest is stale; otherwise false.
+             */
+            auto isStale() const -> bool;
+
+            /**
+             * @brief       Adds a component folder to the manifest.
+             *
+             * @param[in]   path the path of the folder.
+             */
+            auto addFolder(const QString &path) -> void;
+
+            /**
+             * @brief       Adds a component to the manifest, components must be added in load order.
+             *
+             * @param[in]   filename the absolute filename of the component.
+             * @param[in]   fingerprint the fingerprint of the file, the inode is not stored.
+             * @param[in]   metadata the metadata of the component.
+             * @param[in]   loadFlags the load flags of the component, only used by snapshots.
+             */
+            auto addEntry(
+                    const QString &filename,
+                    const ComponentFingerprint &fingerprint,
+                    const QJsonObject &metadata,
+                    int loadFlags = 0) -> void;
+
+            /**
+             * @brief       Sets whether the manifest is a snapshot of a completed load.
+             *
+             * @param[in]   isSnapshot true if the manifest is a snapshot; otherwise false.
+             */
+            auto setSnapshot(bool isSnapshot) -> void;
+
+            /**
+             * @brief       Returns whether the manifest is a snapshot of a completed load.
+             *
+             * @returns     true if the manifest is a snapshot; otherwise false.
+             */
+            auto isSnapshot() const -> bool;
+
+            /**
+             * @brief       Sets the names of the components that were disabled by the application.
+             *
+             * @param[in]   disabledComponents the names of the disabled components.
+             */
+            auto setDisabledComponents(const QStringList &disabledComponents) -> void;
+
+            /**
+             * @brief       Returns the names of the components that were disabled by the application.
+             *
+             * @returns     the names of the disabled components.
+             */
+            auto disabledComponents() const -> QStringList;
+
+            /**
+             * @brief       Returns the component folders.
+             *
+             * @returns     the folders, with absolute paths.
+             */
+            auto folders() const -> QList<Folder>;
+
+            /**
+             * @brief       Returns the components in load order.
+             *
+             * @returns     the components, with absolute filenames.
+             */
+            auto entries() const -> QList<Entry>;
+
+        private:
+            //! @cond
+
+            QList<Folder> m_folders;
+            QList<Entry> m_entries;
+            QStringList m_disabledComponents;
+            bool m_isSnapshot = false;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_COMPONENTSYSTEM_COMPONENTMANIFEST_H
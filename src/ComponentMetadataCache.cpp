@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ComponentMetadataCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QJsonDocument>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#if defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#endif
+
+constexpr quint32 CacheMagic = 0x4E435343;      // "NCSC"
+constexpr quint32 CacheVersion = 2;              // version 2 stores the metadata as compact json
+
+auto Nedrysoft::ComponentSystem::ComponentFingerprint::fromFile(
+        const QFileInfo &fileInfo) -> Nedrysoft::ComponentSystem::ComponentFingerprint {
+
+    ComponentFingerprint fingerprint;
+
+    fingerprint.size = fileInfo.size();
+    fingerprint.modified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+#if defined(Q_OS_UNIX)
+    struct stat fileStat = {};
+
+    if (::stat(QFile::encodeName(fileInfo.absoluteFilePath()).constData(), &fileStat) == 0) {
+        fingerprint.inode = static_cast<quint64>(fileStat.st_ino);
+    }
+#endif
+
+    return fingerprint;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentFingerprint::operator==(
+        const Nedrysoft::ComponentSystem::ComponentFingerprint &other) const -> bool {
+
+    if (( size != other.size ) || ( modified != other.modified )) {
+        return false;
+    }
+
+    // an unknown inode only matches another unknown inode, so a file that reports no inode is still compared by
+    // its size and modification time without weakening the comparison of files that do
+
+    return inode == other.inode;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentFingerprint::operator!=(
+        const Nedrysoft::ComponentSystem::ComponentFingerprint &other) const -> bool {
+
+    return !( *this == other );
+}
+
+Nedrysoft::ComponentSystem::ComponentMetadataCache::ComponentMetadataCache(const QString &filename) :
+        m_filename(filename),
+        m_modified(false) {
+
+}
+
+auto Nedrysoft::ComponentSystem::ComponentMetadataCache::load() -> bool {
+    QMutexLocker locker(&m_mutex);
+
+    m_entries.clear();
+    m_modified = false;
+
+    QFile cacheFile(m_filename);
+
+    if (!cacheFile.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&cacheFile);
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic, version, entryCount;
+
+    stream >> magic >> version >> entryCount;
+
+    if (( stream.status() != QDataStream::Ok ) || ( magic != CacheMagic ) || ( version != CacheVersion )) {
+        return false;
+    }
+
+    m_entries.reserve(static_cast<int>(entryCount));
+
+    for (quint32 entryIndex = 0; entryIndex < entryCount; entryIndex++) {
+        QString filename;
+        Entry entry;
+
+        stream >> filename >> entry.fingerprint.size >> entry.fingerprint.modified >> entry.fingerprint.inode
+               >> entry.metadata;
+
+        if (stream.status() != QDataStream::Ok) {
+            m_entries.clear();
+
+            return false;
+        }
+
+        m_entries[filename] = entry;
+    }
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentMetadataCache::save() -> bool {
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_modified) {
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(m_filename).absolutePath());
+
+    QSaveFile cacheFile(m_filename);
+
+    if (!cacheFile.open(QFile::WriteOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&cacheFile);
+
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << CacheMagic << CacheVersion << static_cast<quint32>(m_entries.count());
+
+    for (auto entryIterator = m_entries.constBegin(); entryIterator != m_entries.constEnd(); entryIterator++) {
+        auto &entry = entryIterator.value();
+
+        stream << entryIterator.key() << entry.fingerprint.size << entry.fingerprint.modified
+               << entry.fingerprint.inode << entry.metadata;
+    }
+
+    if (!cacheFile.commit()) {
+        return false;
+    }
+
+    m_modified = false;
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentMetadataCache::find(
+        const QString &filename,
+        const Nedrysoft::ComponentSystem::ComponentFingerprint &fingerprint,
+        QJsonObject &metadata) -> bool {
+
+    QMutexLocker locker(&m_mutex);
+
+    auto entryIterator = m_entries.find(filename);
+
+    if (entryIterator == m_entries.end()) {
+        return false;
+    }
+
+    if (entryIterator->fingerprint != fingerprint) {
+        return false;
+    }
+
+    entryIterator->used = true;
+
+    if (entryIterator->metadata.isEmpty()) {
+        metadata = QJsonObject();
+    } else {
+        metadata = QJsonDocument::fromJson(entryIterator->metadata).object();
+    }
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentMetadataCache::insert(
+        const QString &filename,
+        const Nedrysoft::ComponentSystem::ComponentFingerprint &fingerprint,
+        const QJsonObject &metadata) -> void {
+
+    Entry entry;
+
+    entry.fingerprint = fingerprint;
+    entry.used = true;
+
+    if (!metadata.isEmpty()) {
+        entry.metadata = QJsonDocument(metadata).toJson(QJsonDocument::Compact);
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    m_entries[filename] = entry;
+    m_modified = true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentMetadataCache::removeUnused(const QString &folder) -> void {
+    QMutexLocker locker(&m_mutex);
+
+    auto folderPath = QDir(folder).absolutePath();
+
+    for (auto entryIterator = m_entries.begin(); entryIterator != m_entries.end();) {
+        if (!entryIterator->used && ( QFileInfo(entryIterator.key()).absolutePath() == folderPath )) {
+            entryIterator = m_entries.erase(entryIterator);
+
+            m_modified = true;
+        } else {
+            entryIterator++;
+        }
+    }
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_COMPONENTSYSTEM_COMPONENTMETADATACACHE_H
+#define NEDRYSOFT_COMPONENTSYSTEM_COMPONENTMETADATACACHE_H
+
+#include <QByteArray>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+
+namespace Nedrysoft { namespace ComponentSystem {
+    /**
+     * @brief       The ComponentFingerprint identifies a specific revision of a component file.
+     *
+     * @details     A fingerprint is made up of the file size, the modification time and (where the platform
+     *              supports it) the inode of the file, if any of these change then the file is considered to
+     *              have changed.  An inode of zero is unknown, it only matches another unknown inode.
+     */
+    struct ComponentFingerprint {
+        qint64 size = -1;
+        qint64 modified = -1;
+        quint64 inode = 0;
+
+        /**
+         * @brief       Creates the fingerprint for the given file.
+         *
+         * @param[in]   fileInfo the file information.
+         *
+         * @returns     the fingerprint of the file.
+         */
+        static auto fromFile(const QFileInfo &fileInfo) -> ComponentFingerprint;
+
+        /**
+         * @brief       Compares two fingerprints.
+         *
+         * @param[in]   other the fingerprint to compare against.
+         *
+         * @returns     true if the fingerprints are identical; otherwise false.
+         */
+        auto operator==(const ComponentFingerprint &other) const -> bool;
+
+        /**
+         * @brief       Compares two fingerprints.
+         *
+         * @param[in]   other the fingerprint to compare against.
+         *
+         * @returns     true if the fingerprints differ; otherwise false.
+         */
+        auto operator!=(const ComponentFingerprint &other) const -> bool;
+    };
+
+    /**
+     * @brief       The ComponentMetadataCache stores the embedded metadata of component files on disk.
+     *
+     * @details     Reading the metadata of a plugin requires the shared library to be opened and scanned, for
+     *              a large number of components (or components residing on a slow file system) this is the
+     *              bulk of the discovery cost.  The cache stores the metadata keyed by the absolute path of the
+     *              file and its fingerprint in a compact binary file, so that unchanged files do not need to be
+     *              read again.
+     *
+     *              Lookups and insertions are thread safe.
+     *
+     * @class       Nedrysoft::ComponentSystem::ComponentMetadataCache ComponentMetadataCache.h <ComponentMetadataCache>
+     */
+    class ComponentMetadataCache {
+        public:
+            /**
+             * @brief       Constructs a new ComponentMetadataCache which is persisted to the given file.
+             *
+             * @param[in]   filename the filename of the cache file.
+             */
+            explicit ComponentMetadataCache(const QString &filename);
+
+            /**
+             * @brief       Reads the cache from disk.
+             *
+             * @details     A missing, unreadable or incompatible cache file results in an empty cache.
+             *
+             * @returns     true if the cache was read; otherwise false.
+             */
+            auto load() -> bool;
+
+            /**
+             * @brief       Writes the cache to disk if it has been modified since it was loaded.
+             *
+             * @returns     true if the cache was written (or did not need writing); otherwise false.
+             */
+            auto save() -> bool;
+
+            /**
+             * @brief       Looks up the metadata for a file in the cache.
+             *
+             * @param[in]   filename the absolute filename of the component.
+             * @param[in]   fingerprint the current fingerprint of the file.
+             * @param[out]  metadata the cached metadata, an empty object is returned for files that were
+             *              previously found to not contain any metadata.
+             *
+             * @returns     true if the cache held an entry with a matching fingerprint; otherwise false.
+             */
+            auto find(const QString &filename, const ComponentFingerprint &fingerprint, QJsonObject &metadata) -> bool;
+
+            /**
+             * @brief       Adds or replaces the metadata for a file in the cache.
+             *
+             * @param[in]   filename the absolute filename of the component.
+             * @param[in]   fingerprint the fingerprint of the file the metadata was read from.
+             * @param[in]   metadata the metadata read from the file.
+             */
+            auto insert(const QString &filename, const ComponentFingerprint &fingerprint, const QJsonObject &metadata) -> void;
+
+            /**
+             * @brief       Removes entries in the given folder that were not used since the cache was loaded.
+             *
+             * @details     Called after a folder has been scanned to remove files that no longer exist.
+             *
+             * @param[in]   folder the absolute path of the folder that was scanned.
+             */
+            auto removeUnused(const QString &folder) -> void;
+
+        private:
+            //! @cond
+
+            struct Entry {
+                ComponentFingerprint fingerprint;
+                QByteArray metadata;
+                bool used = false;
+            };
+
+            QString m_filename;
+            QHash<QString, Entry> m_entries;
+            QMutex m_mutex;
+            bool m_modified;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_COMPONENTSYSTEM_COMPONENTMETADATACACHE_H
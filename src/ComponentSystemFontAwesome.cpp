@@ -21,20 +21,59 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-
 #include "ComponentSystemFontAwesome.h"
 
-#include <QFile>
+#include "ComponentSystemFontAwesomeGlyphs.h"
+
 #include <QFontDatabase>
+#include <QGuiApplication>
+#include <QLatin1String>
 #include <QPainter>
 #include <QRegularExpression>
 
+#include <algorithm>
+
 constexpr auto BaseHex = 16;
+constexpr auto IconCacheSize = 256;             // number of icons
+constexpr auto RichTextCacheSize = 1024*1024;   // characters
+
+namespace {
+    /**
+     * @brief       Returns the codepoint of the named glyph.
+     *
+     * @details     The generated glyph table is sorted by name, so the glyph is found with a binary search.
+     *
+     * @param[in]   glyphName the name of the glyph, including the "fa-" prefix.
+     *
+     * @returns     the codepoint of the glyph if found; otherwise 0.
+     */
+    auto glyphCodepoint(const QString &glyphName) -> char16_t {
+        using Nedrysoft::ComponentSystem::FontAwesomeGlyphs::Glyph;
+        using Nedrysoft::ComponentSystem::FontAwesomeGlyphs::Glyphs;
+        using Nedrysoft::ComponentSystem::FontAwesomeGlyphs::GlyphCount;
+
+        auto glyphIterator = std::lower_bound(
+                Glyphs,
+                Glyphs+GlyphCount,
+                glyphName,
+                [](const Glyph &glyph, const QString &name) {
+                    return QLatin1String(glyph.name) < name;
+                } );
+
+        if (( glyphIterator == Glyphs+GlyphCount ) || ( QLatin1String(glyphIterator->name) != glyphName )) {
+            return 0;
+        }
+
+        return glyphIterator->codepoint;
+    }
+}
 
 Nedrysoft::ComponentSystem::FontAwesome::FontAwesome() :
         m_regularId(QFontDatabase::addApplicationFont(":/Nedrysoft/ComponentSystem/FontAwesome/Free-Regular.otf")),
         m_solidId(QFontDatabase::addApplicationFont(":/Nedrysoft/ComponentSystem/FontAwesome/Free-Solid.otf")),
-        m_brandsId(QFontDatabase::addApplicationFont(":/Nedrysoft/ComponentSystem/FontAwesome/Free-Brands.otf")) {
+        m_brandsId(QFontDatabase::addApplicationFont(":/Nedrysoft/ComponentSystem/FontAwesome/Free-Brands.otf")),
+        m_iconCache(IconCacheSize),
+        m_richTextCache(RichTextCacheSize) {
 
     if (QFontDatabase::applicationFontFamilies(m_regularId).count()) {
         m_regularName = QFontDatabase::applicationFontFamilies(m_regularId).at(0);
@@ -48,28 +87,6 @@ Nedrysoft::ComponentSystem::FontAwesome::FontAwesome() :
         m_brandsName = QFontDatabase::applicationFontFamilies(m_brandsId).at(0);
     }
 
-    QFile scssFile(":/Nedrysoft/ComponentSystem/FontAwesome/_variables.scss");
-
-    if (scssFile.open(QFile::ReadOnly)) {
-        auto scssContent = QString::fromUtf8(scssFile.readAll());
-
-        if (!scssContent.isEmpty()) {
-            auto scssExpression = QRegularExpression(R"(\$fa-var-([0-9|a-z|\-]*)\:\W\\([0-9|a-f]{1,4});)");
-
-            auto scssMatchIterator = scssExpression.globalMatch(scssContent);
-
-            while (scssMatchIterator.hasNext()) {
-                auto scssMatch = scssMatchIterator.next();
-
-                auto capturedTexts = scssMatch.capturedTexts();
-
-                if (capturedTexts.count() == 3) {
-                    m_glyphMap["fa-" + capturedTexts.at(1)] = capturedTexts.at(2);
-                }
-            }
-        }
-    }
-
     m_styleString = QString(R"(
         <style>
             .far {
@@ -93,6 +110,31 @@ Nedrysoft::ComponentSystem::FontAwesome::FontAwesome() :
             }
         </style>
     )").arg(m_regularName, m_solidName, m_brandsName);
+
+    // the cached icons hold pixmaps, which must be released while the application object still exists rather than
+    // when the static instance is destroyed.  aboutToQuit is not emitted if the event loop was never run, so the
+    // caches are also cleared as the application object is destroyed
+
+    if (qApp) {
+        QObject::connect(qApp, &QCoreApplication::aboutToQuit, qApp, [this]() {
+            clearCaches();
+        });
+    }
+
+    qAddPostRoutine([]() {
+        Nedrysoft::ComponentSystem::FontAwesome::getInstance()->clearCaches();
+    });
+}
+
+auto Nedrysoft::ComponentSystem::FontAwesome::clearCaches() -> void {
+    m_iconCache.clear();
+    m_richTextCache.clear();
+}
+
+auto Nedrysoft::ComponentSystem::FontAwesome::getInstance() -> Nedrysoft::ComponentSystem::FontAwesome * {
+    static FontAwesome fontAwesome;
+
+    return &fontAwesome;
 }
 
 auto Nedrysoft::ComponentSystem::FontAwesome::regularName() -> QString {
@@ -107,103 +149,149 @@ auto Nedrysoft::ComponentSystem::FontAwesome::brandsName() -> QString {
     return m_brandsName;
 }
 
-auto Nedrysoft::ComponentSystem::FontAwesome::richText(QString string) -> QString {
-    auto expression = QRegularExpression(R"(\[(far|fas|fab) ([a-z|\-|0-9]*)\])");
-    auto match = QRegularExpressionMatch();
-    auto searchIndex = 0;
+auto Nedrysoft::ComponentSystem::FontAwesome::richText(const QString &string, bool cacheResult) -> QString {
+    static const auto expression = QRegularExpression(R"(\[(far|fas|fab) ([a-z|\-|0-9]*)\])");
+    static const auto htmlPrefix = QString("<html>");
+    static const auto bodyPrefix = QString("<body>");
+    static const auto bodySuffix = QString("</body></html>");
+
+    if (cacheResult) {
+        auto cachedText = m_richTextCache.object(string);
 
-    while (string.indexOf(expression, searchIndex, &match) >= 0) {
-        if (!match.hasMatch()) {
-            break;
+        if (cachedText) {
+            return *cachedText;
         }
+    }
+
+    // the text is copied to the output in a single pass, each tag is expanded in place as it is reached
+
+    auto expandedText = QString();
+    auto lastIndex = 0;
+
+    expandedText.reserve(
+            htmlPrefix.length()+m_styleString.length()+bodyPrefix.length()+
+            string.length()+bodySuffix.length() );
 
-        if (match.capturedTexts().count() == 3) {
-            auto richTextString = QString();
-            auto iconFont = match.capturedTexts().at(1);
-            auto iconId = match.capturedTexts().at(2);
-            auto iconCode = QString();
+    expandedText.append(htmlPrefix);
+    expandedText.append(m_styleString);
+    expandedText.append(bodyPrefix);
 
-            if (m_glyphMap.contains(iconId)) {
-                iconCode = m_glyphMap[iconId];
-            } else {
-                if (( iconId.size() >= 1 ) && (( iconId.size() <= 4 ))) {
-                    bool ok = false;
+    auto matchIterator = expression.globalMatch(string);
 
-                    iconId.toInt(&ok, BaseHex);
+    while (matchIterator.hasNext()) {
+        auto match = matchIterator.next();
+        auto iconFont = match.captured(1);
+        auto iconId = match.captured(2);
+        auto iconCode = QString();
+        auto glyphCode = glyphCodepoint(iconId);
 
-                    if (ok) {
-                        iconCode = iconId;
-                    }
+        expandedText.append(string.constData()+lastIndex, match.capturedStart()-lastIndex);
+
+        lastIndex = match.capturedEnd();
+
+        if (glyphCode) {
+            iconCode = QString::number(glyphCode, BaseHex);
+        } else {
+            if (( iconId.size() >= 1 ) && (( iconId.size() <= 4 ))) {
+                bool ok = false;
+
+                iconId.toInt(&ok, BaseHex);
+
+                if (ok) {
+                    iconCode = iconId;
                 }
             }
+        }
 
-            if (iconCode.isNull()) {
-                richTextString = QString("");
-            } else {
-                richTextString = QString(R"(<span class="%1">&#x%2;</span>)").arg(iconFont, iconCode);
-            }
+        // an unknown glyph is removed from the text
 
-            string.replace(match.capturedTexts().at(0), richTextString);
-        } else {
-            searchIndex += match.captured().length();
+        if (!iconCode.isNull()) {
+            expandedText.append(R"(<span class=")");
+            expandedText.append(iconFont);
+            expandedText.append(R"(">&#x)");
+            expandedText.append(iconCode);
+            expandedText.append(";</span>");
         }
     }
 
-    return QString("<html>%1<body>%2</body></html>").arg(m_styleString, string);
+    expandedText.append(string.constData()+lastIndex, string.length()-lastIndex);
+    expandedText.append(bodySuffix);
+
+    // the key is held by the cache as well, so it is counted towards the cost of the entry
+
+    if (cacheResult) {
+        m_richTextCache.insert(string, new QString(expandedText), string.length()+expandedText.length());
+    }
+
+    return expandedText;
 }
 
-auto Nedrysoft::ComponentSystem::FontAwesome::icon(QString glyphName, int pointSize, QColor colour) -> QIcon {
-    QPixmap pixmap(pointSize, pointSize);
+auto Nedrysoft::ComponentSystem::FontAwesome::icon(
+        QString glyphName,
+        int pointSize,
+        QColor colour,
+        qreal devicePixelRatio) -> QIcon {
 
-    pixmap.fill(Qt::transparent);
+    static const auto expression = QRegularExpression(R"((far|fas|fab) ([a-z|\-|0-9]*))");
 
-    auto expression = QRegularExpression(R"((far|fas|fab) ([a-z|\-|0-9]*))");
-    auto match = QRegularExpressionMatch();
-    auto searchIndex = 0;
+    if (devicePixelRatio <= 0) {
+        devicePixelRatio = qApp ? qApp->devicePixelRatio() : 1;
+    }
 
-    while (glyphName.indexOf(expression, searchIndex, &match) >= 0) {
-        if (!match.hasMatch()) {
-            break;
-        }
+    auto cacheKey = QString("%1:%2:%3:%4").arg(glyphName).arg(pointSize).arg(colour.rgba()).arg(devicePixelRatio);
 
-        if (match.capturedTexts().count() == 3) {
-            auto iconFont = match.capturedTexts().at(1);
-            auto iconId = match.capturedTexts().at(2);
-            auto iconCode = 0;
-            QFont::Weight fontWeight;
-            QString fontName;
-
-            if (m_glyphMap.contains(iconId)) {
-                iconCode = m_glyphMap[iconId].toInt(nullptr, 16);
-            } else {
-                if (( iconId.size() >= 1 ) && (( iconId.size() <= 4 ))) {
-                    iconCode = iconId.toInt(nullptr, BaseHex);
-                }
-            }
+    auto cachedIcon = m_iconCache.object(cacheKey);
 
-            if (iconFont == "fab") {
-                fontName = brandsName();
-                fontWeight = QFont::Normal;
-            } else if (iconFont == "fas") {
-                fontName = solidName();
-                fontWeight = QFont::Bold;
-            } else {
-                fontName = regularName();
-                fontWeight = QFont::Normal;
-            }
+    if (cachedIcon) {
+        return *cachedIcon;
+    }
+
+    // the pixmap is rendered at the device resolution, the painter works in device independent pixels
 
-            auto *painter = new QPainter(&pixmap);
+    QPixmap pixmap(QSize(pointSize, pointSize)*devicePixelRatio);
 
-            painter->setPen(colour);
-            painter->setFont(QFont(fontName, pointSize, fontWeight));
-            painter->drawText(QRect(0, 0, pointSize, pointSize), Qt::AlignHCenter | Qt::AlignVCenter, QChar(iconCode));
-            painter->end();
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    auto match = expression.match(glyphName);
 
-            delete painter;
+    if (match.hasMatch()) {
+        auto iconFont = match.captured(1);
+        auto iconId = match.captured(2);
+        auto iconCode = 0;
+        QFont::Weight fontWeight;
+        QString fontName;
 
-            break;
+        iconCode = glyphCodepoint(iconId);
+
+        if (!iconCode) {
+            if (( iconId.size() >= 1 ) && (( iconId.size() <= 4 ))) {
+                iconCode = iconId.toInt(nullptr, BaseHex);
+            }
         }
+
+        if (iconFont == "fab") {
+            fontName = brandsName();
+            fontWeight = QFont::Normal;
+        } else if (iconFont == "fas") {
+            fontName = solidName();
+            fontWeight = QFont::Bold;
+        } else {
+            fontName = regularName();
+            fontWeight = QFont::Normal;
+        }
+
+        QPainter painter(&pixmap);
+
+        painter.setPen(colour);
+        painter.setFont(QFont(fontName, pointSize, fontWeight));
+        painter.drawText(QRect(0, 0, pointSize, pointSize), Qt::AlignHCenter | Qt::AlignVCenter, QChar(iconCode));
+        painter.end();
     }
 
-    return QIcon(pixmap);
+    auto icon = QIcon(pixmap);
+
+    m_iconCache.insert(cacheKey, new QIcon(icon));
+
+    return icon;
 }
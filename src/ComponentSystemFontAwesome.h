@@ -24,8 +24,9 @@
 #ifndef NEDRYSOFT_COMPONENTSYSTEM_FONTAWESOME_H
 #define NEDRYSOFT_COMPONENTSYSTEM_FONTAWESOME_H
 
+#include <QCache>
+#include <QColor>
 #include <QIcon>
-#include <QMap>
 #include <QString>
 
 //TODO: link to the main FontAwesome library
@@ -34,14 +35,27 @@ namespace Nedrysoft::ComponentSystem {
     /**
      * @brief       The FontAwesome class provides functions to use the FontAwesome library.
      *
+     * @details     The fonts are registered with the font database once per process, the shared instance is
+     *              obtained with getInstance.  The glyph names are looked up in a table that is generated from
+     *              the FontAwesome SCSS variables at build time.
+     *
      * @class       Nedrysoft::ComponentSystem::FontAwesome FontAwesome.h <FontAwesome>
      */
     class FontAwesome {
-        public:
+        private:
             /**
              * @brief       Constructs a new FontAwesome instance.
              */
             FontAwesome();
+
+        public:
+            /**
+             * @brief       Returns the shared FontAwesome instance.
+             *
+             * @returns     the FontAwesome instance.
+             */
+            static auto getInstance() -> FontAwesome *;
+
             /**
              * @brief       Returns the name of the brands font.
              *
@@ -69,22 +83,40 @@ namespace Nedrysoft::ComponentSystem {
              * @details     takes a QString with tags in [fas|fab|far \<glyph name\>] and produces a HTML rich text
              *              which then includes the respective font awesome glyphs in
              *
+             *              The text is expanded in a single pass, callers that convert the same fixed strings
+             *              repeatedly can ask for the expansion to be cached so that it is only expanded once.
+             *
              * @param[in]   string the text to convert.
+             * @param[in]   cacheResult true if the expansion should be cached; otherwise false.
              *
              * @returns     the rich text.
              */
-            auto richText(QString string) -> QString;
+            auto richText(const QString &string, bool cacheResult = false) -> QString;
 
             /**
              * @brief       Returns a QIcon of a font awesome glyph.
              *
+             * @details     The rendered icons are held in a least recently used cache keyed by the glyph, size,
+             *              colour and device pixel ratio, so each icon is only rendered once per scale factor and
+             *              repeated requests return the same shared QIcon.
+             *
              * @param[in]   glyphName the name of the font awesome glyph,
              * @param[in]   pointSize the size in points of the icon.
              * @param[in]   colour the colour for the resulting icon.
+             * @param[in]   devicePixelRatio the scale factor to render the icon at, if 0 then the device pixel
+             *              ratio of the application is used.
              *
              * @returns     the QIcon of the FontAwesome glyph.
              */
-            auto icon(QString glyphName, int pointSize, QColor colour) -> QIcon;
+            auto icon(QString glyphName, int pointSize, QColor colour, qreal devicePixelRatio = 0) -> QIcon;
+
+        private:
+            /**
+             * @brief       Releases the cached icons and rich text.
+             *
+             * @details     Called before the application object is destroyed, as pixmaps must not outlive it.
+             */
+            auto clearCaches() -> void;
 
         private:
             //! @cond
@@ -99,7 +131,8 @@ namespace Nedrysoft::ComponentSystem {
 
             QString m_styleString;
 
-            QMap<QString, QString> m_glyphMap;
+            QCache<QString, QIcon> m_iconCache;
+            QCache<QString, QString> m_richTextCache;
 
             //! @endcond
     };
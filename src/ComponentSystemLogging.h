@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_COMPONENTSYSTEM_COMPONENTSYSTEMLOGGING_H
+#define NEDRYSOFT_COMPONENTSYSTEM_COMPONENTSYSTEMLOGGING_H
+
+#include "spdlog.h"
+
+/**
+ * @brief       Logs a message at the given level if the default logger would output it.
+ *
+ * @details     The level is checked before the arguments are evaluated, so any formatting or conversion in the
+ *              arguments (e.g QString::toStdString) costs nothing when the level is disabled.  The message
+ *              uses the fmt format syntax, e.g NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO("found {}", name.toStdString()).
+ *
+ *              Levels below SPDLOG_ACTIVE_LEVEL are compiled out entirely, as with the SPDLOG_ macros.
+ *
+ * @note        This header is private to the component system.
+ */
+#define NEDRYSOFT_COMPONENTSYSTEM_LOG(level, ...) \
+    do { \
+        auto componentSystemLogger = spdlog::default_logger_raw(); \
+        if (componentSystemLogger->should_log(level)) { \
+            SPDLOG_LOGGER_CALL(componentSystemLogger, level, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(...) NEDRYSOFT_COMPONENTSYSTEM_LOG(spdlog::level::info, __VA_ARGS__)
+#else
+#define NEDRYSOFT_COMPONENTSYSTEM_LOG_INFO(...) (void) 0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define NEDRYSOFT_COMPONENTSYSTEM_LOG_WARN(...) NEDRYSOFT_COMPONENTSYSTEM_LOG(spdlog::level::warn, __VA_ARGS__)
+#else
+#define NEDRYSOFT_COMPONENTSYSTEM_LOG_WARN(...) (void) 0
+#endif
+
+#endif // NEDRYSOFT_COMPONENTSYSTEM_COMPONENTSYSTEMLOGGING_H
@@ -25,11 +25,11 @@
 
 #include "Component.h"
 #include "ComponentDetailsDialog.h"
+#include "ComponentViewerModel.h"
 #include "IComponentManager.h"
-#include "ComponentSystemFontAwesome.h"
 #include "ui_ComponentViewerDialog.h"
 
-#include <QTreeWidgetItem>
+#include <QSortFilterProxyModel>
 
 Nedrysoft::ComponentSystem::ComponentViewerDialog::ComponentViewerDialog(QWidget *parent) :
         QDialog(parent),
@@ -37,101 +37,46 @@ Nedrysoft::ComponentSystem::ComponentViewerDialog::ComponentViewerDialog(QWidget
 
     ui->setupUi(this);
 
-    m_fontAwesome = new Nedrysoft::ComponentSystem::FontAwesome;
-
-    auto minusIcon = m_fontAwesome->icon("fas fa-minus", 16, Qt::darkRed);
-    auto crossIcon = m_fontAwesome->icon("fas fa-times", 16, Qt::darkRed);
-    auto tickIcon = m_fontAwesome->icon("fas fa-check", 16, Qt::darkGreen);
-
-    ui->componentsTreeWidget->setHeaderLabels(
-            QStringList() << tr("Name") << tr("Load") << tr("Version") << tr("Vendor"));
-
-    ui->componentsTreeWidget->setColumnWidth(0, 300);
-    ui->componentsTreeWidget->setColumnWidth(1, 50);
-    ui->componentsTreeWidget->setColumnWidth(2, 300);
-    ui->componentsTreeWidget->setColumnWidth(3, 200);
-
-    QMap<QString, QMap<QString, Nedrysoft::ComponentSystem::Component *> > categoryMap;
-
     auto componentLoader = Nedrysoft::ComponentSystem::getObject<Nedrysoft::ComponentSystem::ComponentLoader>();
 
-    auto components = componentLoader->components();
-
-    for (auto component : components) {
-        categoryMap[component->category()][component->name()] = component;
-    }
-
-    QMapIterator<QString, QMap<QString, Nedrysoft::ComponentSystem::Component *> > categoryIterator(categoryMap);
-
-    while (categoryIterator.hasNext()) {
-        categoryIterator.next();
-
-        auto categoryItem = new QTreeWidgetItem;
-
-        categoryItem->setText(0, categoryIterator.key());
-
-        QMapIterator<QString, Nedrysoft::ComponentSystem::Component *> componentIterator(categoryIterator.value());
-
-        while (componentIterator.hasNext()) {
-            componentIterator.next();
+    m_componentModel = new Nedrysoft::ComponentSystem::ComponentViewerModel(componentLoader->components(), this);
 
-            auto component = componentIterator.value();
+    m_proxyModel = new QSortFilterProxyModel(this);
 
-            auto componentItem = new QTreeWidgetItem;
+    m_proxyModel->setSourceModel(m_componentModel);
+    m_proxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    m_proxyModel->setFilterKeyColumn(-1);
+    m_proxyModel->setRecursiveFilteringEnabled(true);
 
-            if (component->loadStatus() == Nedrysoft::ComponentSystem::ComponentLoader::Loaded) {
-                componentItem->setIcon(0, tickIcon);
-            } else {
-                if (component->loadStatus() == Nedrysoft::ComponentSystem::ComponentLoader::Disabled) {
-                    componentItem->setIcon(0, minusIcon);
-                } else {
-                    componentItem->setIcon(0, crossIcon);
-                }
-            }
+    ui->componentsTreeView->setModel(m_proxyModel);
 
-            componentItem->setText(0, component->name());
+    ui->componentsTreeView->setColumnWidth(Nedrysoft::ComponentSystem::ComponentViewerModel::NameColumn, 300);
+    ui->componentsTreeView->setColumnWidth(Nedrysoft::ComponentSystem::ComponentViewerModel::LoadColumn, 50);
+    ui->componentsTreeView->setColumnWidth(Nedrysoft::ComponentSystem::ComponentViewerModel::VersionColumn, 300);
+    ui->componentsTreeView->setColumnWidth(Nedrysoft::ComponentSystem::ComponentViewerModel::VendorColumn, 200);
+    ui->componentsTreeView->setColumnWidth(Nedrysoft::ComponentSystem::ComponentViewerModel::ImageSizeColumn, 100);
+    ui->componentsTreeView->setColumnWidth(Nedrysoft::ComponentSystem::ComponentViewerModel::ObjectsColumn, 70);
 
-            if (!component->canBeDisabled()) {
-                componentItem->setData(1, Qt::CheckStateRole, Qt::Checked);
-                componentItem->setDisabled(true);
-            } else {
-                if (component->loadStatus() == Nedrysoft::ComponentSystem::ComponentLoader::Disabled) {
-                    componentItem->setCheckState(1, Qt::Unchecked);
-                } else {
-                    componentItem->setCheckState(1, Qt::Checked);
-                }
-            }
+    ui->componentsTreeView->expandAll();
 
-            componentItem->setText(2, component->versionString());
-            componentItem->setText(3, component->vendor());
+    connect(ui->searchLineEdit, &QLineEdit::textChanged, this, [=](const QString &text) {
+        m_proxyModel->setFilterFixedString(text);
 
-            componentItem->setData(
-                    0,
-                    Qt::UserRole,
-                    QVariant::fromValue<Nedrysoft::ComponentSystem::Component *>(component) );
+        ui->componentsTreeView->expandAll();
+    });
 
-            categoryItem->addChild(componentItem);
-        }
-
-        ui->componentsTreeWidget->addTopLevelItem(categoryItem);
-    }
-
-    ui->componentsTreeWidget->expandAll();
+    connect(ui->componentsTreeView, &QTreeView::doubleClicked, this,
+            &Nedrysoft::ComponentSystem::ComponentViewerDialog::showComponentDetails);
 }
 
 Nedrysoft::ComponentSystem::ComponentViewerDialog::~ComponentViewerDialog() {
     delete ui;
-
-    delete m_fontAwesome;
 }
 
-void Nedrysoft::ComponentSystem::ComponentViewerDialog::on_componentsTreeWidget_itemDoubleClicked(
-        QTreeWidgetItem *item,
-        int column) {
-
-    Q_UNUSED(column)
-
-    auto component = item->data(0, Qt::UserRole).value<Nedrysoft::ComponentSystem::Component *>();
+auto Nedrysoft::ComponentSystem::ComponentViewerDialog::showComponentDetails(const QModelIndex &index) -> void {
+    auto component = m_proxyModel->data(
+            index,
+            Nedrysoft::ComponentSystem::ComponentViewerModel::ComponentRole).value<Nedrysoft::ComponentSystem::Component *>();
 
     if (component) {
         ComponentDetailsDialog detailsDialog(component);
@@ -141,24 +86,5 @@ void Nedrysoft::ComponentSystem::ComponentViewerDialog::on_componentsTreeWidget_
 }
 
 auto Nedrysoft::ComponentSystem::ComponentViewerDialog::disabledComponents() -> QStringList {
-    QStringList disabledComponentList;
-
-    for (auto categoryIndex = 0; categoryIndex < ui->componentsTreeWidget->topLevelItemCount(); categoryIndex++) {
-        auto categoryItem = ui->componentsTreeWidget->topLevelItem(categoryIndex);
-
-        for (auto itemIndex = 0; itemIndex < categoryItem->childCount(); itemIndex++) {
-            auto componentItem = categoryItem->child(itemIndex);
-
-            if (componentItem->checkState(1) == Qt::Unchecked) {
-                Nedrysoft::ComponentSystem::Component *component = componentItem->data(0,
-                        Qt::UserRole).value<Nedrysoft::ComponentSystem::Component *>();
-
-                if (component) {
-                    disabledComponentList.append(( component->name() + "." + component->vendor()).toLower());
-                }
-            }
-        }
-    }
-
-    return disabledComponentList;
+    return m_componentModel->disabledIdentifiers();
 }
@@ -27,14 +27,16 @@
 #include "ComponentSystemSpec.h"
 
 #include <QDialog>
-#include <QTreeWidgetItem>
+
+class QModelIndex;
+class QSortFilterProxyModel;
 
 namespace Nedrysoft { namespace ComponentSystem {
     namespace Ui {
         class ComponentViewerDialog;
     }
 
-    class FontAwesome;
+    class ComponentViewerModel;
 
     /**
      * @brief       The ComponentViewerDialog provides a dialog which shows all discovered components.
@@ -42,6 +44,9 @@ namespace Nedrysoft { namespace ComponentSystem {
      * @brief       Dialog that shows the list of components detected by the system (although not necessarily loaded).
      *              Allows further detailed information to be displayed.
      *
+     * @details     The components are presented by a ComponentViewerModel, the search box filters the view
+     *              through a proxy model.
+     *
      * @class       Nedrysoft::ComponentSystem::ComponentViewerDialog ComponentViewerDialog.h <ComponentViewerDialog>
      */
     class COMPONENT_SYSTEM_DLLSPEC ComponentViewerDialog :
@@ -82,17 +87,17 @@ namespace Nedrysoft { namespace ComponentSystem {
              *
              * @details     Opens the ComponentDetailsDialog for the given component that has been double clicked.
              *
-             * @param[in]   item the item that was double clicked.
-             * @param[in]   column the column that was double clicked.
+             * @param[in]   index the proxy model index of the item that was double clicked.
              */
-            Q_SLOT void on_componentsTreeWidget_itemDoubleClicked(QTreeWidgetItem *item, int column);
+            auto showComponentDetails(const QModelIndex &index) -> void;
 
         private:
             //! @cond
 
             Ui::ComponentViewerDialog *ui;
 
-            FontAwesome *m_fontAwesome;
+            Nedrysoft::ComponentSystem::ComponentViewerModel *m_componentModel;
+            QSortFilterProxyModel *m_proxyModel;
 
             //! @endcond
     };
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ComponentViewerModel.h"
+
+#include "Component.h"
+#include "ComponentLoader.h"
+#include "ComponentSystemFontAwesome.h"
+#include "IComponentManager.h"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QLocale>
+
+#include <algorithm>
+
+constexpr auto IconSize = 16;
+
+namespace {
+    /**
+     * @brief       Returns the identifier that the loader uses to disable the component.
+     *
+     * @param[in]   component the component.
+     *
+     * @returns     the reverse domain name identifier.
+     */
+    auto disableIdentifier(Nedrysoft::ComponentSystem::Component *component) -> QString {
+        return ( component->name() + "." + component->vendor() ).toLower();
+    }
+}
+
+Nedrysoft::ComponentSystem::ComponentViewerModel::ComponentViewerModel(
+        const QList<Nedrysoft::ComponentSystem::Component *> &components,
+        QObject *parent) :
+
+        QAbstractItemModel(parent) {
+
+    auto fontAwesome = Nedrysoft::ComponentSystem::FontAwesome::getInstance();
+
+    m_loadedIcon = fontAwesome->icon("fas fa-check", IconSize, Qt::darkGreen);
+    m_disabledIcon = fontAwesome->icon("fas fa-minus", IconSize, Qt::darkRed);
+    m_failedIcon = fontAwesome->icon("fas fa-times", IconSize, Qt::darkRed);
+
+    QHash<QString, int> categoryRows;
+
+    // the process mappings are read once for all of the components, they are not available on every platform
+
+    auto imageSizes = Nedrysoft::ComponentSystem::Component::mappedImageSizes();
+
+    for (auto component : components) {
+        auto categoryIterator = categoryRows.constFind(component->category());
+
+        if (categoryIterator == categoryRows.constEnd()) {
+            categoryIterator = categoryRows.insert(component->category(), m_categories.count());
+
+            m_categories.append(Category{component->category(), {}});
+        }
+
+        m_categories[*categoryIterator].components.append(component);
+
+        if (component->isLoaded() && !component->isStatic()) {
+            m_imageSizes[component] = imageSizes.value(QFileInfo(component->filename()).canonicalFilePath());
+        }
+
+        if (component->canBeDisabled() &&
+                ( component->loadStatus() == Nedrysoft::ComponentSystem::ComponentLoader::Disabled )) {
+
+            m_disabledIdentifiers.insert(disableIdentifier(component));
+        }
+    }
+
+    std::sort(m_categories.begin(), m_categories.end(), [](const Category &left, const Category &right) {
+        return left.name < right.name;
+    });
+
+    for (auto &category : m_categories) {
+        std::sort(
+                category.components.begin(),
+                category.components.end(),
+                [](Nedrysoft::ComponentSystem::Component *left, Nedrysoft::ComponentSystem::Component *right) {
+                    return left->name() < right->name();
+                } );
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::disabledIdentifiers() const -> QStringList {
+    // the set has no stable order, the list is sorted so that the same selection is always persisted the same way
+
+    auto identifiers = m_disabledIdentifiers.values();
+
+    std::sort(identifiers.begin(), identifiers.end());
+
+    return identifiers;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::index(
+        int row,
+        int column,
+        const QModelIndex &parent) const -> QModelIndex {
+
+    if (!hasIndex(row, column, parent)) {
+        return QModelIndex();
+    }
+
+    // category rows have an internal id of 0, component rows store the row of their category plus 1
+
+    if (!parent.isValid()) {
+        return createIndex(row, column, quintptr(0));
+    }
+
+    return createIndex(row, column, quintptr(parent.row()+1));
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::parent(const QModelIndex &index) const -> QModelIndex {
+    if (!index.isValid() || ( index.internalId() == 0 )) {
+        return QModelIndex();
+    }
+
+    return createIndex(static_cast<int>(index.internalId()-1), 0, quintptr(0));
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::rowCount(const QModelIndex &parent) const -> int {
+    if (!parent.isValid()) {
+        return m_categories.count();
+    }
+
+    if (( parent.internalId() == 0 ) && ( parent.column() == 0 )) {
+        return m_categories.at(parent.row()).components.count();
+    }
+
+    return 0;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::columnCount(const QModelIndex &parent) const -> int {
+    Q_UNUSED(parent)
+
+    return ColumnCount;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::component(
+        const QModelIndex &index) const -> Nedrysoft::ComponentSystem::Component * {
+
+    if (!index.isValid() || ( index.internalId() == 0 )) {
+        return nullptr;
+    }
+
+    return m_categories.at(static_cast<int>(index.internalId()-1)).components.at(index.row());
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::data(const QModelIndex &index, int role) const -> QVariant {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    auto component = this->component(index);
+
+    if (!component) {
+        if (( role == Qt::DisplayRole ) && ( index.column() == NameColumn )) {
+            return m_categories.at(index.row()).name;
+        }
+
+        return QVariant();
+    }
+
+    switch (role) {
+        case ComponentRole: {
+            return QVariant::fromValue<Nedrysoft::ComponentSystem::Component *>(component);
+        }
+
+        case Qt::DisplayRole: {
+            switch (index.column()) {
+                case NameColumn: {
+                    return component->name();
+                }
+
+                case VersionColumn: {
+                    return component->versionString();
+                }
+
+                case VendorColumn: {
+                    return component->vendor();
+                }
+
+                case ImageSizeColumn: {
+                    auto imageSize = m_imageSizes.value(component);
+
+                    if (imageSize <= 0) {
+                        return QVariant();
+                    }
+
+                    return QLocale().formattedDataSize(imageSize);
+                }
+
+                case ObjectsColumn: {
+                    if (( !component->isLoaded() ) ||
+                        ( !Nedrysoft::ComponentSystem::IComponentManager::getInstance()->isOwnerTrackingEnabled() )) {
+                        return QVariant();
+                    }
+
+                    return component->registeredObjectCount();
+                }
+
+                default: {
+                    return QVariant();
+                }
+            }
+        }
+
+        case Qt::DecorationRole: {
+            if (index.column() != NameColumn) {
+                return QVariant();
+            }
+
+            if (component->loadStatus() == Nedrysoft::ComponentSystem::ComponentLoader::Loaded) {
+                return m_loadedIcon;
+            }
+
+            if (component->loadStatus() == Nedrysoft::ComponentSystem::ComponentLoader::Disabled) {
+                return m_disabledIcon;
+            }
+
+            return m_failedIcon;
+        }
+
+        case Qt::CheckStateRole: {
+            if (index.column() != LoadColumn) {
+                return QVariant();
+            }
+
+            if (!component->canBeDisabled()) {
+                return Qt::Checked;
+            }
+
+            return m_disabledIdentifiers.contains(disableIdentifier(component)) ? Qt::Unchecked : Qt::Checked;
+        }
+
+        case Qt::ToolTipRole: {
+            return component->description().trimmed();
+        }
+
+        default: {
+            return QVariant();
+        }
+    }
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::setData(
+        const QModelIndex &index,
+        const QVariant &value,
+        int role) -> bool {
+
+    auto component = this->component(index);
+
+    if (!component || ( role != Qt::CheckStateRole ) || ( index.column() != LoadColumn )) {
+        return false;
+    }
+
+    if (!component->canBeDisabled()) {
+        return false;
+    }
+
+    if (value.toInt() == Qt::Unchecked) {
+        m_disabledIdentifiers.insert(disableIdentifier(component));
+    } else {
+        m_disabledIdentifiers.remove(disableIdentifier(component));
+    }
+
+    Q_EMIT dataChanged(index, index, QVector<int>() << Qt::CheckStateRole);
+
+    return true;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::flags(const QModelIndex &index) const -> Qt::ItemFlags {
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+
+    auto component = this->component(index);
+
+    if (!component) {
+        return Qt::ItemIsEnabled;
+    }
+
+    if (!component->canBeDisabled()) {
+        return Qt::ItemIsSelectable;
+    }
+
+    if (index.column() == LoadColumn) {
+        return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsUserCheckable;
+    }
+
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+auto Nedrysoft::ComponentSystem::ComponentViewerModel::headerData(
+        int section,
+        Qt::Orientation orientation,
+        int role) const -> QVariant {
+
+    if (( orientation != Qt::Horizontal ) || ( role != Qt::DisplayRole )) {
+        return QVariant();
+    }
+
+    switch (section) {
+        case NameColumn: {
+            return tr("Name");
+        }
+
+        case LoadColumn: {
+            return tr("Load");
+        }
+
+        case VersionColumn: {
+            return tr("Version");
+        }
+
+        case VendorColumn: {
+            return tr("Vendor");
+        }
+
+        case ImageSizeColumn: {
+            return tr("Image Size");
+        }
+
+        case ObjectsColumn: {
+            return tr("Objects");
+        }
+
+        default: {
+            return QVariant();
+        }
+    }
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NEDRYSOFT_COMPONENTSYSTEM_COMPONENTVIEWERMODEL_H
+#define NEDRYSOFT_COMPONENTSYSTEM_COMPONENTVIEWERMODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QIcon>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace Nedrysoft { namespace ComponentSystem {
+    class Component;
+
+    /**
+     * @brief       The ComponentViewerModel presents the discovered components grouped by category.
+     *
+     * @details     The model refers directly to the Component instances owned by the loader, the values for
+     *              each row are only retrieved from the component when a view asks for them.  The identifiers
+     *              of the components that have been unchecked are kept in a set which is updated as the
+     *              check boxes are toggled.
+     *
+     *              The mapped image sizes of the component libraries are read once when the model is created,
+     *              the number of registered objects is read from the registry when it is displayed.
+     *
+     * @class       Nedrysoft::ComponentSystem::ComponentViewerModel ComponentViewerModel.h <ComponentViewerModel>
+     */
+    class ComponentViewerModel :
+            public QAbstractItemModel {
+
+        private:
+            Q_OBJECT
+
+        public:
+            /**
+             * @brief       The columns provided by the model.
+             */
+            enum Column {
+                NameColumn = 0,
+                LoadColumn,
+                VersionColumn,
+                VendorColumn,
+                ImageSizeColumn,
+                ObjectsColumn,
+                ColumnCount
+            };
+
+            /**
+             * @brief       The custom data roles provided by the model.
+             */
+            enum Role {
+                ComponentRole = Qt::UserRole                    /**< the Component pointer of a component row. */
+            };
+
+            /**
+             * @brief       Constructs a new ComponentViewerModel for the given components.
+             *
+             * @param[in]   components the components to present.
+             * @param[in]   parent the parent object.
+             */
+            explicit ComponentViewerModel(
+                    const QList<Nedrysoft::ComponentSystem::Component *> &components,
+                    QObject *parent = nullptr );
+
+            /**
+             * @brief       Returns the identifiers of the components that are unchecked.
+             *
+             * @returns     the sorted list of disabled component identifiers.
+             */
+            auto disabledIdentifiers() const -> QStringList;
+
+            /**
+             * @brief       Reimplements: QAbstractItemModel::index(int row, int column, const QModelIndex &parent).
+             *
+             * @param[in]   row the row.
+             * @param[in]   column the column.
+             * @param[in]   parent the parent index.
+             *
+             * @returns     the index of the item.
+             */
+            auto index(int row, int column, const QModelIndex &parent = QModelIndex()) const -> QModelIndex override;
+
+            /**
+             * @brief       Reimplements: QAbstractItemModel::parent(const QModelIndex &index).
+             *
+             * @param[in]   index the index of the item.
+             *
+             * @returns     the index of the parent item.
+             */
+            auto parent(const QModelIndex &index) const -> QModelIndex override;
+
+            /**
+             * @brief       Reimplements: QAbstractItemModel::rowCount(const QModelIndex &parent).
+             *
+             * @param[in]   parent the parent index.
+             *
+             * @returns     the number of rows under the parent.
+             */
+            auto rowCount(const QModelIndex &parent = QModelIndex()) const -> int override;
+
+            /**
+             * @brief       Reimplements: QAbstractItemModel::columnCount(const QModelIndex &parent).
+             *
+             * @param[in]   parent the parent index.
+             *
+             * @returns     the number of columns.
+             */
+            auto columnCount(const QModelIndex &parent = QModelIndex()) const -> int override;
+
+            /**
+             * @brief       Reimplements: QAbstractItemModel::data(const QModelIndex &index, int role).
+             *
+             * @param[in]   index the index of the item.
+             * @param[in]   role the data role.
+             *
+             * @returns     the data for the role.
+             */
+            auto data(const QModelIndex &index, int role = Qt::DisplayRole) const -> QVariant override;
+
+            /**
+             * @brief       Reimplements: QAbstractItemModel::setData(const QModelIndex &index, const QVariant &value, int role).
+             *
+             * @details     Only the check state of the load column can be changed.
+             *
+             * @param[in]   index the index of the item.
+             * @param[in]   value the new value.
+             * @param[in]   role the data role.
+             *
+             * @returns     true if the data was changed; otherwise false.
+             */
+            auto setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) -> bool override;
+
+            /**
+             * @brief       Reimplements: QAbstractItemModel::flags(const QModelIndex &index).
+             *
+             * @param[in]   index the index of the item.
+             *
+             * @returns     the item flags.
+             */
+            auto flags(const QModelIndex &index) const -> Qt::ItemFlags override;
+
+            /**
+             * @brief       Reimplements: QAbstractItemModel::headerData(int section, Qt::Orientation orientation, int role).
+             *
+             * @param[in]   section the section.
+             * @param[in]   orientation the orientation of the header.
+             * @param[in]   role the data role.
+             *
+             * @returns     the header data for the role.
+             */
+            auto headerData(
+                    int section,
+                    Qt::Orientation orientation,
+                    int role = Qt::DisplayRole) const -> QVariant override;
+
+        private:
+            /**
+             * @brief       Returns the component at the given index.
+             *
+             * @param[in]   index the index of the item.
+             *
+             * @returns     the component if the index is a component row; otherwise nullptr.
+             */
+            auto component(const QModelIndex &index) const -> Nedrysoft::ComponentSystem::Component *;
+
+        private:
+            //! @cond
+
+            struct Category {
+                QString name;
+                QVector<Nedrysoft::ComponentSystem::Component *> components;
+            };
+
+            QVector<Category> m_categories;
+            QSet<QString> m_disabledIdentifiers;
+            QHash<Nedrysoft::ComponentSystem::Component *, qint64> m_imageSizes;
+
+            QIcon m_loadedIcon;
+            QIcon m_disabledIcon;
+            QIcon m_failedIcon;
+
+            //! @endcond
+    };
+}}
+
+#endif // NEDRYSOFT_COMPONENTSYSTEM_COMPONENTVIEWERMODEL_H
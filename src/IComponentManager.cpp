@@ -23,7 +23,72 @@
 
 #include "IComponentManager.h"
 
-Nedrysoft::ComponentSystem::IComponentManager::~IComponentManager() = default;
+#include <QMutexLocker>
+#include <QSet>
+#include <QThread>
+
+namespace {
+    /**
+     * @brief       The component that owns the objects that the current thread adds to the registry.
+     */
+    thread_local const Nedrysoft::ComponentSystem::Component *currentObjectOwner = nullptr;
+}
+
+/**
+ * @brief       The HazardSlot records the snapshot that a thread is reading.
+ *
+ * @details     A slot is claimed by a thread the first time that it reads the registry and is only written by that
+ *              thread, so readers never write to memory shared with other readers.  When the thread exits the
+ *              slot is released for reuse by another thread, slots are deleted along with the manager.
+ */
+struct Nedrysoft::ComponentSystem::IComponentManager::HazardSlot {
+    std::atomic<const Registry *> registry;
+    std::atomic<bool> inUse;
+    HazardSlot *next;
+};
+
+/**
+ * @brief       The Activation holds an activator and tracks whether it has been called.
+ */
+struct Nedrysoft::ComponentSystem::IComponentManager::Activation {
+    enum class State {
+        Pending,
+        Running,
+        Finished
+    };
+
+    QObject *owner;
+    QByteArray interfaceName;
+    std::function<void()> activator;
+    State state;
+    QThread *thread;
+};
+
+Nedrysoft::ComponentSystem::IComponentManager::IComponentManager() :
+        m_registry(new Registry),
+        m_hazardSlots(nullptr),
+        m_pending(new Registry),
+        m_generation(0),
+        m_ownerTracking(false) {
+
+}
+
+Nedrysoft::ComponentSystem::IComponentManager::~IComponentManager() {
+    qDeleteAll(m_retired);
+
+    delete m_registry.load();
+    delete m_pending;
+
+    auto slot = m_hazardSlots.load();
+
+    while (slot) {
+        auto nextSlot = slot->next;
+
+        delete slot;
+
+        slot = nextSlot;
+    }
+}
 
 auto Nedrysoft::ComponentSystem::IComponentManager::getInstance() -> Nedrysoft::ComponentSystem::IComponentManager * {
     static IComponentManager componentManager;
@@ -32,13 +97,578 @@ auto Nedrysoft::ComponentSystem::IComponentManager::getInstance() -> Nedrysoft::
 }
 
 auto Nedrysoft::ComponentSystem::IComponentManager::addObject(QObject *object) -> void {
-    m_objectList.append(object);
+    insertObjects(QList<QObject *>() << object);
+
+    Q_EMIT objectAdded(object);
+    Q_EMIT objectsAdded(QList<QObject *>() << object);
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::addObject(
+        QObject *object,
+        const Nedrysoft::ComponentSystem::IComponentManager::InterfaceCasts &interfaceCasts) -> void {
+
+    QHash<QObject *, InterfaceCasts> objectCasts;
+
+    objectCasts.insert(object, interfaceCasts);
+
+    insertObjects(QList<QObject *>() << object, objectCasts);
+
+    Q_EMIT objectAdded(object);
+    Q_EMIT objectsAdded(QList<QObject *>() << object);
 }
 
 auto Nedrysoft::ComponentSystem::IComponentManager::removeObject(QObject *object) -> void {
-    m_objectList.removeAll(object);
+    eraseObjects(QList<QObject *>() << object);
+
+    Q_EMIT objectRemoved(object);
+    Q_EMIT objectsRemoved(QList<QObject *>() << object);
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::addObjects(const QList<QObject *> &objects) -> void {
+    if (objects.isEmpty()) {
+        return;
+    }
+
+    insertObjects(objects);
+
+    Q_EMIT objectsAdded(objects);
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::removeObjects(const QList<QObject *> &objects) -> void {
+    if (objects.isEmpty()) {
+        return;
+    }
+
+    eraseObjects(objects);
+
+    Q_EMIT objectsRemoved(objects);
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::insertObjects(
+        const QList<QObject *> &objects,
+        const QHash<QObject *, InterfaceCasts> &interfaceCasts) -> void {
+
+    QMutexLocker locker(&m_writeMutex);
+
+    auto registry = m_pending;
+
+    registry->objects.append(objects);
+
+    if (( m_ownerTracking ) && ( currentObjectOwner )) {
+        for (auto object : objects) {
+            m_objectOwners.insert(object, currentObjectOwner);
+        }
+
+        m_ownedObjectCounts[currentObjectOwner] += objects.count();
+    }
+
+    for (auto castsIterator = interfaceCasts.constBegin(); castsIterator != interfaceCasts.constEnd(); castsIterator++) {
+        registry->interfaceCasts.insert(castsIterator.key(), castsIterator.value());
+    }
+
+    // update the index of every type that has already been looked up
+
+    for (auto index : { &registry->interfaceIndex, &registry->classIndex }) {
+        auto isInterface = ( index == &registry->interfaceIndex );
+
+        for (auto indexIterator = index->begin(); indexIterator != index->end(); indexIterator++) {
+            for (auto object : objects) {
+                auto castPointer = castObject(*registry, object, indexIterator.key().constData(), isInterface);
+
+                if (castPointer) {
+                    indexIterator->objects.append(object);
+                    indexIterator->casts.append(castPointer);
+                }
+            }
+        }
+    }
+
+    // the generation changes after the snapshot has been published, so a lookup that sees the new generation
+    // also sees the new objects
+
+    publishPending();
+
+    m_generation.fetchAndAddOrdered(1);
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::eraseObjects(const QList<QObject *> &objects) -> void {
+    QMutexLocker locker(&m_writeMutex);
+
+    auto registry = m_pending;
+
+    for (auto object : objects) {
+        registry->objects.removeAll(object);
+        registry->interfaceCasts.remove(object);
+
+        if (!m_ownerTracking) {
+            continue;
+        }
+
+        auto ownerIterator = m_objectOwners.find(object);
+
+        if (ownerIterator != m_objectOwners.end()) {
+            m_ownedObjectCounts[ownerIterator.value()]--;
+
+            m_objectOwners.erase(ownerIterator);
+        }
+    }
+
+    for (auto index : { &registry->interfaceIndex, &registry->classIndex }) {
+        for (auto indexIterator = index->begin(); indexIterator != index->end(); indexIterator++) {
+            for (auto object : objects) {
+                int objectIndex;
+
+                while (( objectIndex = indexIterator->objects.indexOf(object) ) >= 0) {
+                    indexIterator->objects.removeAt(objectIndex);
+                    indexIterator->casts.removeAt(objectIndex);
+                }
+            }
+        }
+    }
+
+    publishPending();
+
+    m_generation.fetchAndAddOrdered(1);
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::findObjects(const char *typeName, bool isInterface) -> QList<void *> {
+    if (!typeName) {
+        return QList<void *>();
+    }
+
+    auto typeKey = QByteArray::fromRawData(typeName, static_cast<int>(qstrlen(typeName)));
+
+    // fast path, the type has already been indexed in the current snapshot
+
+    auto currentRegistry = acquireSnapshot();
+    auto &currentIndex = isInterface ? currentRegistry->interfaceIndex : currentRegistry->classIndex;
+    auto indexIterator = currentIndex.constFind(typeKey);
+
+    if (indexIterator != currentIndex.constEnd()) {
+        auto casts = indexIterator->casts;
+
+        releaseSnapshot();
+
+        return casts;
+    }
+
+    releaseSnapshot();
+
+    // first lookup of this type, build the index entry and publish a new snapshot containing it
+
+    QMutexLocker locker(&m_writeMutex);
+
+    auto registry = m_pending;
+    auto &index = isInterface ? registry->interfaceIndex : registry->classIndex;
+
+    indexIterator = index.constFind(typeKey);
+
+    if (indexIterator != index.constEnd()) {
+        return indexIterator->casts;
+    }
+
+    TypeIndex typeIndex;
+
+    for (auto object : registry->objects) {
+        auto castPointer = castObject(*registry, object, typeName, isInterface);
+
+        if (castPointer) {
+            typeIndex.objects.append(object);
+            typeIndex.casts.append(castPointer);
+        }
+    }
+
+    index.insert(QByteArray(typeName), typeIndex);
+
+    publishPending();
+
+    return typeIndex.casts;
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::castObject(
+        const Registry &registry,
+        QObject *object,
+        const char *typeName,
+        bool isInterface) -> void * {
+
+    if (!object) {
+        return nullptr;
+    }
+
+    if (isInterface) {
+        // pointers supplied at registration avoid the string comparisons in qt_metacast
+
+        auto castsIterator = registry.interfaceCasts.constFind(object);
+
+        if (castsIterator != registry.interfaceCasts.constEnd()) {
+            auto castIterator = castsIterator->constFind(
+                    QByteArray::fromRawData(typeName, static_cast<int>(qstrlen(typeName))) );
+
+            if (castIterator != castsIterator->constEnd()) {
+                return castIterator.value();
+            }
+        }
+
+        return object->qt_metacast(typeName);
+    }
+
+    return object->inherits(typeName) ? static_cast<void *>(object) : nullptr;
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::generation() const -> int {
+    return m_generation.loadAcquire();
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::setCurrentOwner(
+        const Nedrysoft::ComponentSystem::Component *owner) -> const Nedrysoft::ComponentSystem::Component * {
+
+    auto previousOwner = currentObjectOwner;
+
+    currentObjectOwner = owner;
+
+    return previousOwner;
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::setOwnerTrackingEnabled(bool enabled) -> void {
+    QMutexLocker locker(&m_writeMutex);
+
+    m_ownerTracking = enabled;
+
+    if (!enabled) {
+        m_objectOwners.clear();
+        m_ownedObjectCounts.clear();
+    }
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::isOwnerTrackingEnabled() -> bool {
+    QMutexLocker locker(&m_writeMutex);
+
+    return m_ownerTracking;
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::ownedObjectCount(
+        const Nedrysoft::ComponentSystem::Component *owner) -> int {
+
+    QMutexLocker locker(&m_writeMutex);
+
+    return m_ownedObjectCounts.value(owner);
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::acquireSnapshot() -> const Registry * {
+    auto slot = hazardSlot();
+    auto registry = m_registry.load();
+
+    // the snapshot is protected before it is used, and the pointer is checked again in case the snapshot was
+    // replaced (and reclaimed) before the protection became visible to the writer
+
+    while (true) {
+        slot->registry.store(registry);
+
+        auto currentRegistry = m_registry.load();
+
+        if (currentRegistry == registry) {
+            return registry;
+        }
+
+        registry = currentRegistry;
+    }
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::releaseSnapshot() -> void {
+    hazardSlot()->registry.store(nullptr, std::memory_order_release);
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::hazardSlot() -> HazardSlot * {
+    struct SlotClaim {
+        HazardSlot *slot;
+
+        ~SlotClaim() {
+            slot->registry.store(nullptr);
+            slot->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    // the manager is a singleton, so each thread only ever needs a single slot
+
+    thread_local SlotClaim slotClaim = { claimHazardSlot() };
+
+    return slotClaim.slot;
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::claimHazardSlot() -> HazardSlot * {
+    for (auto slot = m_hazardSlots.load(std::memory_order_acquire); slot; slot = slot->next) {
+        auto inUse = false;
+
+        if (slot->inUse.compare_exchange_strong(inUse, true)) {
+            return slot;
+        }
+    }
+
+    // slots are never removed from the list while the manager exists, so a new slot is simply pushed to the front
+
+    auto slot = new HazardSlot;
+
+    slot->registry.store(nullptr);
+    slot->inUse.store(true);
+    slot->next = m_hazardSlots.load();
+
+    while (!m_hazardSlots.compare_exchange_weak(slot->next, slot)) {
+    }
+
+    return slot;
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::publishPending() -> void {
+    // the copy shares the data of the private registry, the private registry is copied (detached) by the next
+    // modification
+
+    auto previousRegistry = m_registry.exchange(new Registry(*m_pending));
+
+    m_retired.append(previousRegistry);
+
+    reclaimRetired();
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::reclaimRetired() -> void {
+    // a reader that protects a snapshot after the slots have been read finds that the snapshot has been replaced
+    // and moves on to the current one, which is never in the retired list
+
+    QSet<const Registry *> protectedRegistries;
+
+    for (auto slot = m_hazardSlots.load(std::memory_order_acquire); slot; slot = slot->next) {
+        auto registry = slot->registry.load();
+
+        if (registry) {
+            protectedRegistries.insert(registry);
+        }
+    }
+
+    for (auto retiredIterator = m_retired.begin(); retiredIterator != m_retired.end();) {
+        if (protectedRegistries.contains(*retiredIterator)) {
+            retiredIterator++;
+        } else {
+            delete *retiredIterator;
+
+            retiredIterator = m_retired.erase(retiredIterator);
+        }
+    }
 }
 
 auto Nedrysoft::ComponentSystem::IComponentManager::allObjects() -> QList<QObject *> {
-    return m_objectList;
+    auto registry = acquireSnapshot();
+    auto objects = registry->objects;
+
+    releaseSnapshot();
+
+    return objects;
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::addActivator(
+        QObject *owner,
+        const QString &interfaceName,
+        std::function<void()> activator) -> void {
+
+    QMutexLocker locker(&m_writeMutex);
+
+    auto interfaceKey = interfaceName.toLatin1();
+
+    m_activators.insert(interfaceKey, std::shared_ptr<Activation>(new Activation {
+            owner,
+            interfaceKey,
+            std::move(activator),
+            Activation::State::Pending,
+            nullptr }));
+
+    m_activatorCount.storeRelease(m_activators.count());
+
+    if (!m_pending->activatorInterfaces.contains(interfaceKey)) {
+        m_pending->activatorInterfaces.insert(interfaceKey);
+
+        publishPending();
+    }
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::removeActivators(QObject *owner) -> void {
+    QMutexLocker locker(&m_writeMutex);
+
+    for (auto activatorIterator = m_activators.begin(); activatorIterator != m_activators.end();) {
+        auto activation = activatorIterator.value();
+
+        if (activation->owner != owner) {
+            activatorIterator++;
+
+            continue;
+        }
+
+        // a requester waiting for an activation that will now never run is released with whatever is registered
+
+        if (activation->state == Activation::State::Pending) {
+            activation->state = Activation::State::Finished;
+
+            m_requestedActivations.removeAll(activation);
+        }
+
+        activatorIterator = m_activators.erase(activatorIterator);
+    }
+
+    m_activatorCount.storeRelease(m_activators.count());
+
+    updateActivatorInterfaces();
+
+    m_activationFinished.wakeAll();
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::updateActivatorInterfaces() -> void {
+    auto interfacesChanged = false;
+
+    for (auto interfaceIterator = m_pending->activatorInterfaces.begin();
+         interfaceIterator != m_pending->activatorInterfaces.end();) {
+
+        if (m_activators.contains(*interfaceIterator)) {
+            interfaceIterator++;
+        } else {
+            interfaceIterator = m_pending->activatorInterfaces.erase(interfaceIterator);
+
+            interfacesChanged = true;
+        }
+    }
+
+    if (interfacesChanged) {
+        publishPending();
+    }
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::activate(const char *interfaceName) -> void {
+    if (!interfaceName || !m_activatorCount.loadAcquire()) {
+        return;
+    }
+
+    auto interfaceKey = QByteArray::fromRawData(interfaceName, static_cast<int>(qstrlen(interfaceName)));
+
+    // most lookups are for interfaces without an activator, which are answered from the snapshot without the lock
+
+    auto registry = acquireSnapshot();
+    auto hasActivators = registry->activatorInterfaces.contains(interfaceKey);
+
+    releaseSnapshot();
+
+    if (!hasActivators) {
+        return;
+    }
+
+    QList<std::shared_ptr<Activation> > activations;
+
+    {
+        QMutexLocker locker(&m_writeMutex);
+
+        activations = m_activators.values(interfaceKey);
+    }
+
+    // QMultiHash returns the most recently inserted value first, so call them in reverse to preserve registration order
+
+    for (auto activationIterator = activations.rbegin(); activationIterator != activations.rend(); activationIterator++) {
+        runActivation(*activationIterator);
+    }
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::runActivation(
+        const std::shared_ptr<Activation> &activation) -> void {
+
+    auto owner = activation->owner;
+
+    QMutexLocker locker(&m_writeMutex);
+
+    // activators run on the thread of their owner, which runs a request from another thread either from its event
+    // loop or from runRequestedActivations, while the requester waits for the activation to finish
+
+    if (( owner ) && ( owner->thread() != QThread::currentThread() )) {
+        if (( activation->state == Activation::State::Pending ) && ( !m_requestedActivations.contains(activation) )) {
+            m_requestedActivations.append(activation);
+
+            QMetaObject::invokeMethod(owner, [this]() {
+                runRequestedActivations();
+            }, Qt::QueuedConnection);
+        }
+
+        locker.unlock();
+
+        Q_EMIT activationRequested();
+
+        locker.relock();
+
+        while (activation->state != Activation::State::Finished) {
+            m_activationFinished.wait(&m_writeMutex);
+        }
+
+        return;
+    }
+
+    while (activation->state == Activation::State::Running) {
+        // activating a component may cause lookups of the same interface, which return what is registered so far
+
+        if (activation->thread == QThread::currentThread()) {
+            return;
+        }
+
+        m_activationFinished.wait(&m_writeMutex);
+    }
+
+    if (activation->state == Activation::State::Finished) {
+        return;
+    }
+
+    // the activator stays registered while it runs, so that other requesters find it and wait for it
+
+    activation->state = Activation::State::Running;
+    activation->thread = QThread::currentThread();
+
+    locker.unlock();
+
+    activation->activator();
+
+    locker.relock();
+
+    activation->state = Activation::State::Finished;
+
+    for (auto activatorIterator = m_activators.find(activation->interfaceName);
+         activatorIterator != m_activators.end() && activatorIterator.key() == activation->interfaceName;) {
+
+        if (activatorIterator.value() == activation) {
+            activatorIterator = m_activators.erase(activatorIterator);
+        } else {
+            activatorIterator++;
+        }
+    }
+
+    m_activatorCount.storeRelease(m_activators.count());
+
+    updateActivatorInterfaces();
+
+    m_activationFinished.wakeAll();
+}
+
+auto Nedrysoft::ComponentSystem::IComponentManager::runRequestedActivations() -> void {
+    QList<std::shared_ptr<Activation> > activations;
+
+    {
+        QMutexLocker locker(&m_writeMutex);
+
+        for (auto activationIterator = m_requestedActivations.begin();
+             activationIterator != m_requestedActivations.end();) {
+
+            auto owner = ( *activationIterator )->owner;
+
+            if (( owner ) && ( owner->thread() != QThread::currentThread() )) {
+                activationIterator++;
+            } else {
+                activations.append(*activationIterator);
+
+                activationIterator = m_requestedActivations.erase(activationIterator);
+            }
+        }
+    }
+
+    for (const auto &activation : activations) {
+        runActivation(activation);
+    }
 }
@@ -27,15 +27,40 @@
 #include "ComponentSystemSpec.h"
 #include "IComponent.h"
 
+#include <QByteArray>
+#include <QHash>
+#include <QAtomicInt>
+#include <QMultiHash>
+#include <QMutex>
 #include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <type_traits>
 
 namespace Nedrysoft { namespace ComponentSystem {
+    class Component;
+
     /**
      * @brief       The IComponentManager defines the contract for a class to manage loaded components.
      *
      * @details     In addition to handling the management of components, this class also provides a global
      *              registry for components.
      *
+     *              The registry is safe to use from multiple threads.  Readers work on an immutable snapshot of
+     *              the registry which is published through an atomic pointer, so lookups never take the registry
+     *              lock.  Modifications are serialised and applied to a private copy of the registry, which is
+     *              published as a new snapshot by the modification itself.
+     *
+     *              Publishing shares the data of the private copy, which is copied (at O(n) in the number of
+     *              registered objects) by the next modification, so registering objects as a batch with
+     *              addObjects costs a single copy.  Each reader protects the snapshot that it is reading in a slot
+     *              of its own, and a replaced snapshot is deleted by the next modification once no slot refers to
+     *              it, so reclamation never waits for every reader to be idle at once.
+     *
      * @class       Nedrysoft::ComponentSystem::IComponentManager IComponentManager.h <IComponentManager>
      */
     class COMPONENT_SYSTEM_DLLSPEC IComponentManager :
@@ -48,7 +73,7 @@ namespace Nedrysoft { namespace ComponentSystem {
             /**
              * @brief       `Constructs a new IComponentManager.
              */
-            IComponentManager() = default;
+            IComponentManager();
 
             /**
              * @brief       Destroys the IComponentManager.
@@ -56,6 +81,11 @@ namespace Nedrysoft { namespace ComponentSystem {
             ~IComponentManager();
 
         public:
+            /**
+             * @brief       The pointers of an object cast to the interfaces that it was registered with, by IID.
+             */
+            using InterfaceCasts = QHash<QByteArray, void *>;
+
             /**
              * @brief       Add an object to the object registry.
              *
@@ -63,6 +93,20 @@ namespace Nedrysoft { namespace ComponentSystem {
              */
             auto addObject(QObject *object) -> void;
 
+            /**
+             * @brief       Adds an object to the object registry along with its interface pointers.
+             *
+             * @details     Lookups of the given interfaces use the supplied pointers instead of casting the object
+             *              with qt_metacast, which compares the IID against every interface of the object.  Other
+             *              interfaces of the object are still found by casting.
+             *
+             * @note        Use the addObject<Interfaces...> function rather than calling this directly.
+             *
+             * @param[in]   object object to store.
+             * @param[in]   interfaceCasts the object cast to each of its interfaces, keyed by IID.
+             */
+            auto addObject(QObject *object, const InterfaceCasts &interfaceCasts) -> void;
+
             /**
              * @brief       Removes an object to the object registry.
              *
@@ -70,6 +114,26 @@ namespace Nedrysoft { namespace ComponentSystem {
              */
             auto removeObject(QObject *object) -> void;
 
+            /**
+             * @brief       Adds a list of objects to the object registry.
+             *
+             * @details     The objects are added as a single operation, the type indices are updated once, and a
+             *              single objectsAdded notification is sent.
+             *
+             * @param[in]   objects the objects to store.
+             */
+            auto addObjects(const QList<QObject *> &objects) -> void;
+
+            /**
+             * @brief       Removes a list of objects from the object registry.
+             *
+             * @details     The objects are removed as a single operation, the type indices are updated once, and
+             *              a single objectsRemoved notification is sent.
+             *
+             * @param[in]   objects the objects to remove.
+             */
+            auto removeObjects(const QList<QObject *> &objects) -> void;
+
             /**
              * @brief       Returns a list of all objects in the registry.
              *
@@ -77,6 +141,121 @@ namespace Nedrysoft { namespace ComponentSystem {
              */
             auto allObjects() -> QList<QObject *>;
 
+            /**
+             * @brief       Returns the registered objects of the given type.
+             *
+             * @details     The registry maintains an index for each type that has been looked up, the first lookup
+             *              of a type scans the registry and subsequent lookups return the indexed result directly.
+             *              The indices are kept up to date as objects are added to and removed from the registry.
+             *
+             *              For interfaces the returned pointers are the result of casting each object to the
+             *              interface, for classes the returned pointers are the QObject pointers.
+             *
+             * @note        Use the getObject and getObjects functions rather than calling this directly.
+             *
+             * @param[in]   typeName the IID of the interface or the class name.
+             * @param[in]   isInterface true if typeName is an interface IID; otherwise false.
+             *
+             * @returns     the list of matching objects in registration order.
+             */
+            auto findObjects(const char *typeName, bool isInterface) -> QList<void *>;
+
+            /**
+             * @brief       Returns the generation of the registry.
+             *
+             * @details     The generation is incremented every time that objects are added to or removed from the
+             *              registry, a cached lookup result is still valid for as long as the generation is
+             *              unchanged.
+             *
+             * @returns     the current generation.
+             */
+            auto generation() const -> int;
+
+            /**
+             * @brief       Registers a function that activates a provider of an interface.
+             *
+             * @details     Components that are activated on demand register an activator for each interface that
+             *              they provide, the activator is called (and removed) the first time that an object
+             *              implementing the interface is requested from the registry.  The activator is called on
+             *              the thread of its owner, and other threads that request the interface meanwhile wait
+             *              until it has returned.  A request from another thread is handed to the owner's thread
+             *              through its event loop, or through runRequestedActivations if that thread is busy.
+             *
+             * @param[in]   owner the object that owns the activator.
+             * @param[in]   interfaceName the IID of the interface.
+             * @param[in]   activator the function that activates the provider.
+             */
+            auto addActivator(QObject *owner, const QString &interfaceName, std::function<void()> activator) -> void;
+
+            /**
+             * @brief       Removes all activators belonging to the given owner.
+             *
+             * @param[in]   owner the owner of the activators.
+             */
+            auto removeActivators(QObject *owner) -> void;
+
+            /**
+             * @brief       Calls any pending activators for the given interface.
+             *
+             * @details     Called by getObject and getObjects before the registry is searched.  The interfaces
+             *              that have activators are published with the registry snapshot, so the lock is only
+             *              taken for an interface that a deferred component provides.
+             *
+             * @param[in]   interfaceName the IID of the interface; may be nullptr.
+             */
+            auto activate(const char *interfaceName) -> void;
+
+            /**
+             * @brief       Calls the activators that other threads have requested and that belong to objects of the
+             *              calling thread.
+             *
+             * @details     Requests are normally run by the event loop of the owner's thread, a thread that waits
+             *              for the requesting threads without returning to its event loop calls this function when
+             *              activationRequested is emitted.
+             */
+            auto runRequestedActivations() -> void;
+
+            /**
+             * @brief       Sets the component that owns the objects added to the registry by the calling thread.
+             *
+             * @details     The loader sets the owner while it delivers the lifecycle events of a component, so
+             *              that the objects registered by each component can be counted.
+             *
+             * @param[in]   owner the owning component; may be nullptr.
+             *
+             * @returns     the previous owner, which should be restored afterwards.
+             */
+            static auto setCurrentOwner(const Nedrysoft::ComponentSystem::Component *owner) ->
+                    const Nedrysoft::ComponentSystem::Component *;
+
+            /**
+             * @brief       Sets whether the registry records the component that added each object.
+             *
+             * @details     Tracking is disabled by default, as it costs a hash insertion and removal for every
+             *              object that is registered.  Disabling tracking discards the recorded owners.
+             *
+             * @note        Objects registered before tracking is enabled are not attributed to any component.
+             *
+             * @param[in]   enabled true to track the owners of objects; otherwise false.
+             */
+            auto setOwnerTrackingEnabled(bool enabled) -> void;
+
+            /**
+             * @brief       Returns whether the registry records the component that added each object.
+             *
+             * @returns     true if owners are tracked; otherwise false.
+             */
+            auto isOwnerTrackingEnabled() -> bool;
+
+            /**
+             * @brief       Returns the number of objects in the registry that were added by a component.
+             *
+             * @param[in]   owner the component.
+             *
+             * @returns     the number of registered objects owned by the component; 0 if tracking is disabled.
+             */
+            auto ownedObjectCount(const Nedrysoft::ComponentSystem::Component *owner) -> int;
+
             /**
              * @brief       Returns the singleton instance to the ComponentManager object.
              *
@@ -84,8 +263,195 @@ namespace Nedrysoft { namespace ComponentSystem {
              */
             static auto getInstance() -> IComponentManager *;
 
+        public:
+            /**
+             * @brief       This signal is emitted when an object is added using addObject.
+             *
+             * @param[in]   object the object that was added.
+             */
+            Q_SIGNAL void objectAdded(QObject *object);
+
+            /**
+             * @brief       This signal is emitted when an object is removed using removeObject.
+             *
+             * @param[in]   object the object that was removed.
+             */
+            Q_SIGNAL void objectRemoved(QObject *object);
+
+            /**
+             * @brief       This signal is emitted once for every change that adds objects to the registry.
+             *
+             * @details     Emitted by both addObject and addObjects, a batch registration results in a single
+             *              emission containing every object that was added.
+             *
+             * @param[in]   objects the objects that were added.
+             */
+            Q_SIGNAL void objectsAdded(const QList<QObject *> &objects);
+
+            /**
+             * @brief       This signal is emitted once for every change that removes objects from the registry.
+             *
+             * @details     Emitted by both removeObject and removeObjects, a batch removal results in a single
+             *              emission containing every object that was removed.
+             *
+             * @param[in]   objects the objects that were removed.
+             */
+            Q_SIGNAL void objectsRemoved(const QList<QObject *> &objects);
+
+            /**
+             * @brief       This signal is emitted when an activator is requested from a thread other than the
+             *              thread of its owner.
+             *
+             * @details     The signal is emitted on the requesting thread after the request has been queued, the
+             *              requester then waits until the owner's thread has run the activator.
+             */
+            Q_SIGNAL void activationRequested();
+
+        private:
+            //! @cond
+
+            struct Registry;
+            struct HazardSlot;
+            struct Activation;
+
+            //! @endcond
+
+            /**
+             * @brief       Casts an object to the given type.
+             *
+             * @details     Interface pointers supplied when the object was registered are returned directly.
+             *
+             * @param[in]   registry the registry that the object belongs to.
+             * @param[in]   object the object to cast.
+             * @param[in]   typeName the IID of the interface or the class name.
+             * @param[in]   isInterface true if typeName is an interface IID; otherwise false.
+             *
+             * @returns     the cast pointer if the object implements the type; otherwise nullptr.
+             */
+            static auto castObject(
+                    const Registry &registry,
+                    QObject *object,
+                    const char *typeName,
+                    bool isInterface) -> void *;
+
+            /**
+             * @brief       Adds objects to the private copy of the registry.
+             *
+             * @param[in]   objects the objects to add.
+             * @param[in]   interfaceCasts the interface pointers of the objects, if they were supplied.
+             */
+            auto insertObjects(
+                    const QList<QObject *> &objects,
+                    const QHash<QObject *, InterfaceCasts> &interfaceCasts = QHash<QObject *, InterfaceCasts>()) -> void;
+
+            /**
+             * @brief       Removes objects from the private copy of the registry.
+             *
+             * @param[in]   objects the objects to remove.
+             */
+            auto eraseObjects(const QList<QObject *> &objects) -> void;
+
+            /**
+             * @brief       Calls an activator unless it has already been called.
+             *
+             * @details     The activator is called on the thread of its owner, a request from any other thread is
+             *              queued for the owner's thread and waits until it has finished.  A request made while the
+             *              activator is running waits until it has finished, unless it is made by the activator
+             *              itself, which returns immediately.
+             *
+             * @param[in]   activation the activation to run.
+             */
+            auto runActivation(const std::shared_ptr<Activation> &activation) -> void;
+
+            /**
+             * @brief       Removes the interfaces that no longer have an activator from the published set.
+             *
+             * @note        Must be called with the write lock held.
+             */
+            auto updateActivatorInterfaces() -> void;
+
+        private:
+            //! @cond
+
+            struct TypeIndex {
+                QList<QObject *> objects;
+                QList<void *> casts;
+            };
+
+            struct Registry {
+                QList<QObject *> objects;
+                QHash<QByteArray, TypeIndex> interfaceIndex;
+                QHash<QByteArray, TypeIndex> classIndex;
+                QHash<QObject *, InterfaceCasts> interfaceCasts;
+                QSet<QByteArray> activatorInterfaces;
+            };
+
+            //! @endcond
+
+            /**
+             * @brief       Returns the current snapshot of the registry.
+             *
+             * @details     The snapshot is protected by the hazard slot of the calling thread and remains valid
+             *              until releaseSnapshot is called, values copied out of it (such as the implicitly shared
+             *              lists) remain valid after it has been released.
+             *
+             * @note        A thread may only hold one snapshot at a time.
+             *
+             * @returns     the snapshot.
+             */
+            auto acquireSnapshot() -> const Registry *;
+
+            /**
+             * @brief       Releases a snapshot returned by acquireSnapshot.
+             */
+            auto releaseSnapshot() -> void;
+
+            /**
+             * @brief       Returns the hazard slot of the calling thread, claiming one if needed.
+             *
+             * @returns     the hazard slot.
+             */
+            auto hazardSlot() -> HazardSlot *;
+
+            /**
+             * @brief       Claims an unused hazard slot, or adds a new slot if every slot is in use.
+             *
+             * @returns     the claimed hazard slot.
+             */
+            auto claimHazardSlot() -> HazardSlot *;
+
+            /**
+             * @brief       Publishes the private copy of the registry as a new snapshot.
+             *
+             * @note        Must be called with the write lock held.
+             */
+            auto publishPending() -> void;
+
+            /**
+             * @brief       Deletes the snapshots that have been replaced and are not protected by any reader.
+             *
+             * @note        Must be called with the write lock held.
+             */
+            auto reclaimRetired() -> void;
+
         private:
-            QList<QObject *> m_objectList;
+            //! @cond
+
+            std::atomic<const Registry *> m_registry;
+            std::atomic<HazardSlot *> m_hazardSlots;
+            Registry *m_pending;
+            QList<const Registry *> m_retired;
+            QMutex m_writeMutex;
+            QMultiHash<QByteArray, std::shared_ptr<Activation> > m_activators;
+            QList<std::shared_ptr<Activation> > m_requestedActivations;
+            QWaitCondition m_activationFinished;
+            QAtomicInt m_activatorCount;
+            QAtomicInt m_generation;
+            bool m_ownerTracking;
+            QHash<QObject *, const Nedrysoft::ComponentSystem::Component *> m_objectOwners;
+            QHash<const Nedrysoft::ComponentSystem::Component *, int> m_ownedObjectCounts;
+
+            //! @endcond
     };
 }}
 
@@ -95,11 +461,21 @@ namespace Nedrysoft { namespace ComponentSystem {
  * @code(.cpp)
  *              Nedrysoft::ComponentSystem::addObject(object);
  *
+ *              Nedrysoft::ComponentSystem::addObject<IInterface, IOtherInterface>(object);
+ *
  *              QList<QObject *> objectList = Nedrysoft::ComponentSystem::allObjects();
  *
  *              auto object = Nedrysoft::ComponentSystem::getObject<IInterface>();
  *
  *              QList<IInterface *> objectList = Nedrysoft::ComponentSystem::getObjects<IInterface>();
+ *
+ *              Nedrysoft::ComponentSystem::forEachObject<IInterface>([](IInterface *object) {
+ *                  ...
+ *              });
+ *
+ *              Nedrysoft::ComponentSystem::CachedObject<IInterface> cachedObject;
+ *
+ *              cachedObject->doSomething();
  * @endcode
  */
 namespace Nedrysoft { namespace ComponentSystem {
@@ -112,6 +488,30 @@ namespace Nedrysoft { namespace ComponentSystem {
         IComponentManager::getInstance()->addObject(object);
     }
 
+    /**
+     * @brief       Adds an object to the registry with the pointers for the given interfaces.
+     *
+     * @details     The object is cast to each of the interfaces at compile time, lookups of those interfaces then
+     *              return the stored pointers without the IID string comparisons of qobject_cast.
+     *
+     * @tparam      Interfaces the interfaces (declared with Q_DECLARE_INTERFACE) that the object implements.
+     *
+     * @param[in]   object the object to add to the registry.
+     */
+    template<
+            typename... Interfaces,
+            typename T,
+            typename std::enable_if<( sizeof...(Interfaces) > 0 ), int>::type = 0>
+    inline auto addObject(T *object) -> void {
+        static_assert(std::is_base_of<QObject, T>::value, "the object must be a QObject");
+
+        IComponentManager::InterfaceCasts interfaceCasts;
+
+        ( interfaceCasts.insert(QByteArray(qobject_interface_iid<Interfaces *>()), static_cast<Interfaces *>(object)), ... );
+
+        IComponentManager::getInstance()->addObject(object, interfaceCasts);
+    }
+
     /**
      * @brief       Removes an object to the registry.
      *
@@ -121,6 +521,24 @@ namespace Nedrysoft { namespace ComponentSystem {
         IComponentManager::getInstance()->removeObject(object);
     }
 
+    /**
+     * @brief       Adds a list of objects to the registry in a single operation.
+     *
+     * @param[in]   objects the objects to add to the registry.
+     */
+    inline auto addObjects(const QList<QObject *> &objects) -> void {
+        IComponentManager::getInstance()->addObjects(objects);
+    }
+
+    /**
+     * @brief       Removes a list of objects from the registry in a single operation.
+     *
+     * @param[in]   objects the objects to remove from the registry.
+     */
+    inline auto removeObjects(const QList<QObject *> &objects) -> void {
+        IComponentManager::getInstance()->removeObjects(objects);
+    }
+
     /**
      * @brief       Returns all registered objects.
      *
@@ -130,43 +548,329 @@ namespace Nedrysoft { namespace ComponentSystem {
         return IComponentManager::getInstance()->allObjects();
     }
 
+    /**
+     * @brief       Returns the name used to index objects of type T in the registry.
+     *
+     * @details     Interfaces are indexed by their IID and QObject subclasses by their class name.
+     *
+     * @returns     the type name.
+     */
+    template<typename T>
+    inline auto objectTypeName() -> const char * {
+        if constexpr (std::is_base_of<QObject, T>::value) {
+            if (!qobject_interface_iid<T *>()) {
+                return T::staticMetaObject.className();
+            }
+        }
+
+        return qobject_interface_iid<T *>();
+    }
+
+    /**
+     * @brief       Converts a pointer returned by IComponentManager::findObjects to type T.
+     *
+     * @param[in]   object the pointer returned by the registry.
+     *
+     * @returns     the object as type T.
+     */
+    template<typename T>
+    inline auto objectCast(void *object) -> T* {
+        if constexpr (std::is_base_of<QObject, T>::value) {
+            if (!qobject_interface_iid<T *>()) {
+                return static_cast<T *>(static_cast<QObject *>(object));
+            }
+        }
+
+        return static_cast<T *>(object);
+    }
+
+    /**
+     * @brief       The ObjectRange class provides a non-allocating view of the registered objects of type T.
+     *
+     * @details     The range refers to the list held by the registry snapshot that was current when the range was
+     *              created, obtaining a range does not copy the registry or build a new list and the objects are
+     *              cast to T as they are visited.  The range is unaffected by objects being added or removed
+     *              after it has been created.
+     *
+     * @code(.cpp)
+     *              for (auto object : Nedrysoft::ComponentSystem::getObjectRange<IInterface>()) {
+     *                  ...
+     *              }
+     * @endcode
+     *
+     * @class       Nedrysoft::ComponentSystem::ObjectRange IComponentManager.h <IComponentManager>
+     */
+    template<typename T>
+    class ObjectRange {
+        public:
+            /**
+             * @brief       The Iterator class iterates over the objects in an ObjectRange.
+             */
+            class Iterator {
+                public:
+                    /**
+                     * @brief       Constructs an iterator at the given position.
+                     *
+                     * @param[in]   iterator the position in the underlying list.
+                     */
+                    explicit Iterator(QList<void *>::const_iterator iterator) :
+                            m_iterator(iterator) {
+
+                    }
+
+                    /**
+                     * @brief       Returns the object at the current position.
+                     *
+                     * @returns     the object as type T.
+                     */
+                    auto operator*() const -> T* {
+                        return objectCast<T>(*m_iterator);
+                    }
+
+                    /**
+                     * @brief       Advances the iterator to the next object.
+                     *
+                     * @returns     the iterator.
+                     */
+                    auto operator++() -> Iterator & {
+                        ++m_iterator;
+
+                        return *this;
+                    }
+
+                    /**
+                     * @brief       Compares two iterators.
+                     *
+                     * @param[in]   other the iterator to compare against.
+                     *
+                     * @returns     true if the iterators are at different positions; otherwise false.
+                     */
+                    auto operator!=(const Iterator &other) const -> bool {
+                        return m_iterator != other.m_iterator;
+                    }
+
+                private:
+                    //! @cond
+
+                    QList<void *>::const_iterator m_iterator;
+
+                    //! @endcond
+            };
+
+            /**
+             * @brief       Constructs a range over the given registry list.
+             *
+             * @param[in]   objects the list returned by IComponentManager::findObjects.
+             */
+            explicit ObjectRange(QList<void *> objects) :
+                    m_objects(std::move(objects)) {
+
+            }
+
+            /**
+             * @brief       Returns an iterator to the first object.
+             *
+             * @returns     the iterator.
+             */
+            auto begin() const -> Iterator {
+                return Iterator(m_objects.constBegin());
+            }
+
+            /**
+             * @brief       Returns an iterator past the last object.
+             *
+             * @returns     the iterator.
+             */
+            auto end() const -> Iterator {
+                return Iterator(m_objects.constEnd());
+            }
+
+            /**
+             * @brief       Returns the number of objects in the range.
+             *
+             * @returns     the number of objects.
+             */
+            auto count() const -> int {
+                return static_cast<int>(m_objects.count());
+            }
+
+            /**
+             * @brief       Returns whether the range is empty.
+             *
+             * @returns     true if the range contains no objects; otherwise false.
+             */
+            auto isEmpty() const -> bool {
+                return m_objects.isEmpty();
+            }
+
+        private:
+            //! @cond
+
+            QList<void *> m_objects;
+
+            //! @endcond
+    };
+
+    /**
+     * @brief       Returns a non-allocating range over all objects that implement type T.
+     *
+     * @details     If T is an interface then any deferred components that provide the interface are
+     *              activated first.
+     *
+     * @returns     the range of objects implementing type T.
+     */
+    template<typename T>
+    inline auto getObjectRange() -> ObjectRange<T> {
+        auto componentManager = IComponentManager::getInstance();
+
+        componentManager->activate(qobject_interface_iid<T *>());
+
+        return ObjectRange<T>(
+                componentManager->findObjects(objectTypeName<T>(), qobject_interface_iid<T *>() != nullptr) );
+    }
+
+    /**
+     * @brief       Calls a function for each object that implements type T.
+     *
+     * @details     The objects are visited without building an intermediate list.  If the function returns a
+     *              bool then returning false stops the iteration.
+     *
+     * @param[in]   function the function to call with each object.
+     */
+    template<typename T, typename Function>
+    inline auto forEachObject(Function function) -> void {
+        for (auto object : getObjectRange<T>()) {
+            if constexpr (std::is_same<decltype(function(object)), bool>::value) {
+                if (!function(object)) {
+                    return;
+                }
+            } else {
+                function(object);
+            }
+        }
+    }
+
     /**
      * @brief       Returns the first matching object of type T.
      *
+     * @details     If T is an interface then any deferred components that provide the interface are
+     *              activated first.
+     *
      * @returns     the object of type T.
      */
     template<typename T>
     inline auto getObject() -> T* {
-        for (auto object : IComponentManager::getInstance()->allObjects()) {
+        auto componentManager = IComponentManager::getInstance();
+
+        componentManager->activate(qobject_interface_iid<T *>());
 
-            auto castObject = qobject_cast<T *>(object);
+        auto objects = componentManager->findObjects(objectTypeName<T>(), qobject_interface_iid<T *>() != nullptr);
 
-            if (castObject)
-                return castObject;
+        if (objects.isEmpty()) {
+            return nullptr;
         }
 
-        return nullptr;
+        return objectCast<T>(objects.first());
     }
 
     /**
      * @brief       Returns all objects that implement type T.
      *
+     * @details     If T is an interface then any deferred components that provide the interface are
+     *              activated first.
+     *
      * @returns     the list of objects implementing type T.
      */
     template<typename T>
     inline auto getObjects() -> QList<T *> {
         QList<T *> objectList;
 
-        for (auto object : IComponentManager::getInstance()->allObjects()) {
+        auto componentManager = IComponentManager::getInstance();
+
+        componentManager->activate(qobject_interface_iid<T *>());
 
-            auto castObject = qobject_cast<T *>(object);
+        auto objects = componentManager->findObjects(objectTypeName<T>(), qobject_interface_iid<T *>() != nullptr);
 
-            if (castObject)
-                objectList.append(castObject);
+        objectList.reserve(objects.count());
+
+        for (auto object : objects) {
+            objectList.append(objectCast<T>(object));
         }
 
         return objectList;
     }
+
+    /**
+     * @brief       The CachedObject class holds the result of a getObject lookup for repeated use.
+     *
+     * @details     The object is looked up the first time that it is needed and then reused until the registry
+     *              changes, checking whether the result is still valid is an atomic load and a compare of the
+     *              registry generation.  A CachedObject is intended to be held by code that looks up the same
+     *              type in a tight loop, an instance must not be shared between threads.
+     *
+     * @class       Nedrysoft::ComponentSystem::CachedObject IComponentManager.h <IComponentManager>
+     */
+    template<typename T>
+    class CachedObject {
+        public:
+            /**
+             * @brief       Constructs a new CachedObject, the object is looked up when it is first used.
+             */
+            CachedObject() :
+                    m_componentManager(IComponentManager::getInstance()),
+                    m_object(nullptr),
+                    m_generation(-1) {
+
+            }
+
+            /**
+             * @brief       Returns the first matching object of type T.
+             *
+             * @details     The registry is only searched if objects have been added or removed since the previous
+             *              lookup.
+             *
+             * @returns     the object of type T; or nullptr if there is no matching object.
+             */
+            auto get() -> T* {
+                auto generation = m_componentManager->generation();
+
+                if (generation != m_generation) {
+                    // the generation is read before the lookup, so a change during the lookup causes another one
+
+                    m_object = getObject<T>();
+                    m_generation = generation;
+                }
+
+                return m_object;
+            }
+
+            /**
+             * @brief       Returns the first matching object of type T.
+             *
+             * @returns     the object of type T.
+             */
+            auto operator->() -> T* {
+                return get();
+            }
+
+            /**
+             * @brief       Returns the first matching object of type T.
+             *
+             * @returns     the object of type T.
+             */
+            operator T*() {
+                return get();
+            }
+
+        private:
+            //! @cond
+
+            IComponentManager *m_componentManager;
+            T *m_object;
+            int m_generation;
+
+            //! @endcond
+    };
 }}
 
 #endif // NEDRYSOFT_COMPONENTSYSTEM_ICOMPONENTMANAGER_H
@@ -0,0 +1,99 @@
+#
+# Copyright (C) 2020 Adrian Carpenter
+#
+# This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+#
+# A cross-platform plugin system for Qt applications.
+#
+# Created on 14/10/2026.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+
+# Generates the FontAwesome glyph table from the SCSS variables file, run in script mode:
+#
+#   cmake -DFONTAWESOME_SCSS=<_variables.scss> -DFONTAWESOME_GLYPHS=<output header> -P GenerateFontAwesomeGlyphs.cmake
+#
+# The header contains a constexpr array of glyph names and codepoints sorted by name, so that the glyphs can be
+# found with a binary search without parsing the SCSS at runtime.
+
+if(NOT DEFINED FONTAWESOME_SCSS OR NOT DEFINED FONTAWESOME_GLYPHS)
+    message(FATAL_ERROR "FONTAWESOME_SCSS and FONTAWESOME_GLYPHS must be defined")
+endif()
+
+file(STRINGS "${FONTAWESOME_SCSS}" scssVariables REGEX "^\\$fa-var-[0-9a-z-]+: *\\\\[0-9a-f]+;")
+
+set(glyphEntries "")
+
+foreach(scssVariable IN LISTS scssVariables)
+    string(REGEX REPLACE "^\\$fa-var-([0-9a-z-]+): *\\\\([0-9a-f]+);.*$" "\\1;\\2" glyph "${scssVariable}")
+
+    list(GET glyph 0 glyphName)
+    list(GET glyph 1 glyphCode)
+
+    string(LENGTH "${glyphCode}" glyphCodeLength)
+
+    if(glyphCodeLength GREATER 4)
+        continue()
+    endif()
+
+    list(APPEND glyphEntries "fa-${glyphName} ${glyphCode}")
+endforeach()
+
+# sorting the entries as strings orders them by name, the space separator sorts before every character used in a
+# glyph name so that a name always sorts before any longer name that it is a prefix of
+
+list(SORT glyphEntries)
+list(REMOVE_DUPLICATES glyphEntries)
+
+set(glyphTable "")
+
+foreach(glyphEntry IN LISTS glyphEntries)
+    string(REPLACE " " ";" glyph "${glyphEntry}")
+
+    list(GET glyph 0 glyphName)
+    list(GET glyph 1 glyphCode)
+
+    string(APPEND glyphTable "        { \"${glyphName}\", 0x${glyphCode} },\n")
+endforeach()
+
+list(LENGTH glyphEntries glyphCount)
+
+file(WRITE "${FONTAWESOME_GLYPHS}.tmp"
+"// generated from ${FONTAWESOME_SCSS} by GenerateFontAwesomeGlyphs.cmake, do not edit.
+
+#ifndef NEDRYSOFT_COMPONENTSYSTEM_FONTAWESOMEGLYPHS_H
+#define NEDRYSOFT_COMPONENTSYSTEM_FONTAWESOMEGLYPHS_H
+
+namespace Nedrysoft { namespace ComponentSystem { namespace FontAwesomeGlyphs {
+    struct Glyph {
+        const char *name;
+        char16_t codepoint;
+    };
+
+    constexpr int GlyphCount = ${glyphCount};
+
+    constexpr Glyph Glyphs[GlyphCount] = {
+${glyphTable}    };
+}}}
+
+#endif // NEDRYSOFT_COMPONENTSYSTEM_FONTAWESOMEGLYPHS_H
+")
+
+# only replace the header when the content changes, so that dependent files are not rebuilt needlessly
+
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${FONTAWESOME_GLYPHS}.tmp" "${FONTAWESOME_GLYPHS}")
+
+file(REMOVE "${FONTAWESOME_GLYPHS}.tmp")
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2020 Adrian Carpenter
+ *
+ * This file is part of the Nedrysoft component system (https://github.com/nedrysoft/componentsystem)
+ *
+ * A cross-platform plugin system for Qt applications.
+ *
+ * Created on 14/10/2026.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ComponentLoader.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include <cstdio>
+
+int main(int argc, char **argv) {
+    QCoreApplication application(argc, argv);
+
+    QCommandLineParser parser;
+
+    parser.setApplicationDescription("Writes the component manifest for the components in the given folders.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("manifest", "The filename of the manifest to write.");
+    parser.addPositionalArgument("folders", "The component folders.", "<folder>...");
+
+    parser.process(application);
+
+    auto arguments = parser.positionalArguments();
+
+    if (arguments.count() < 2) {
+        parser.showHelp(1);
+    }
+
+    auto manifestFilename = arguments.takeFirst();
+
+    Nedrysoft::ComponentSystem::ComponentLoader componentLoader;
+
+    componentLoader.addComponents(arguments);
+
+    if (!componentLoader.saveManifest(manifestFilename)) {
+        fprintf(stderr, "unable to write manifest %s\n", qPrintable(manifestFilename));
+
+        return 1;
+    }
+
+    return 0;
+}